@@ -0,0 +1,262 @@
+#include "alloc_tracker.h"
+
+#ifdef GAME_ALLOC_TRACKING
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <spdlog/spdlog.h>
+#include <utility>
+
+namespace game::alloc {
+	namespace {
+#ifdef __cpp_lib_hardware_interference_size
+		constexpr std::size_t CacheLine = std::hardware_destructive_interference_size;
+#else
+		constexpr std::size_t CacheLine = 64;
+#endif
+
+		// Nothing in here may allocate, it runs inside of operator new. Threads charging different tags do not share a
+		// cache line.
+		struct alignas(CacheLine) Slot {
+			std::atomic<std::uint64_t> allocations{ 0 };
+			std::atomic<std::uint64_t> frees{ 0 };
+			std::atomic<std::uint64_t> bytes{ 0 };
+			std::atomic<std::uint64_t> live{ 0 };
+			std::atomic<std::uint64_t> peak{ 0 };
+			std::atomic<std::uint64_t> frameAllocations{ 0 };
+			std::atomic<std::uint64_t> frameFrees{ 0 };
+			std::atomic<std::uint64_t> frameBytes{ 0 };
+			std::atomic<std::uint64_t> framePeak{ 0 };
+		};
+
+		// constant initialized, allocations of other static initializers may come first
+		constinit std::array<Slot, TagCount> slots{};
+		constinit thread_local Tag					 current = Tag::Untagged;
+
+		std::mutex												 frameMutex;
+		std::array<Counters, TagCount>		 lastFrame{};
+		std::uint64_t											 frames = 0;
+
+		void raise(std::atomic<std::uint64_t>& peak, const std::uint64_t value) {
+			auto seen = peak.load(std::memory_order_relaxed);
+			while (seen < value && !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+		}
+
+		Slot& slot(const Tag tag) {
+			return slots[static_cast<std::size_t>(tag)];
+		}
+
+		void charge(const Tag tag, const std::size_t size) {
+			auto& counters = slot(tag);
+			counters.allocations.fetch_add(1, std::memory_order_relaxed);
+			counters.bytes.fetch_add(size, std::memory_order_relaxed);
+			counters.frameAllocations.fetch_add(1, std::memory_order_relaxed);
+			counters.frameBytes.fetch_add(size, std::memory_order_relaxed);
+			const auto live = counters.live.fetch_add(size, std::memory_order_relaxed) + size;
+			raise(counters.peak, live);
+			raise(counters.framePeak, live);
+		}
+
+		void refund(const Tag tag, const std::size_t size) {
+			auto& counters = slot(tag);
+			counters.frees.fetch_add(1, std::memory_order_relaxed);
+			counters.frameFrees.fetch_add(1, std::memory_order_relaxed);
+			counters.live.fetch_sub(size, std::memory_order_relaxed);
+		}
+
+		// Sits right in front of every block handed out, offset leads back to the start of the malloc block
+		struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) Header {
+			std::size_t		size;
+			std::uint32_t offset;
+			Tag						tag;
+		};
+		static_assert(alignof(Header) <= alignof(std::max_align_t), "malloc has to return blocks aligned for the header");
+
+		void* allocate(const std::size_t size, const std::size_t requestedAlignment) noexcept {
+			const auto alignment = std::max(requestedAlignment, alignof(Header));
+			const auto overhead	 = sizeof(Header) + alignment - alignof(Header);
+			if (size > std::numeric_limits<std::size_t>::max() - overhead) { return nullptr; }
+
+			auto* block = static_cast<std::byte*>(std::malloc(size + overhead));
+			if (block == nullptr) { return nullptr; }
+
+			const auto start	 = reinterpret_cast<std::uintptr_t>(block + sizeof(Header));
+			const auto aligned = (start + alignment - 1) & ~(alignment - 1);
+			auto*			 user		 = block + sizeof(Header) + (aligned - start);
+			const auto tag		 = current;
+			::new (user - sizeof(Header)) Header{ size, static_cast<std::uint32_t>(user - block), tag };
+			charge(tag, size);
+			return user;
+		}
+
+		void deallocate(void* pointer) noexcept {
+			if (pointer == nullptr) { return; }
+			auto*				user	 = static_cast<std::byte*>(pointer);
+			const auto& header = *std::launder(reinterpret_cast<Header*>(user - sizeof(Header)));
+			refund(header.tag, header.size);
+			std::free(user - header.offset);
+		}
+
+		void* allocateOrThrow(const std::size_t size, const std::size_t alignment) {
+			while (true) {
+				if (auto* pointer = allocate(size, alignment); pointer != nullptr) { return pointer; }
+				const auto handler = std::get_new_handler();
+				if (handler == nullptr) { throw std::bad_alloc{}; }
+				handler();
+			}
+		}
+
+		void* allocateOrNull(const std::size_t size, const std::size_t alignment) noexcept {
+			try {
+				return allocateOrThrow(size, alignment);
+			} catch (...) {
+				return nullptr;
+			}
+		}
+
+		Counters collect(const Slot& counters) {
+			return Counters{ counters.allocations.load(std::memory_order_relaxed),
+											 counters.frees.load(std::memory_order_relaxed),
+											 counters.bytes.load(std::memory_order_relaxed),
+											 counters.live.load(std::memory_order_relaxed),
+											 counters.peak.load(std::memory_order_relaxed) };
+		}
+	}// namespace
+
+	Tag currentTag() {
+		return current;
+	}
+
+	Scope::Scope(const Tag tag)
+		: _previous{ std::exchange(current, tag) } {}
+
+	Scope::~Scope() {
+		current = _previous;
+	}
+
+	void endFrame() {
+		std::scoped_lock lock{ frameMutex };
+		for (std::size_t index = 0; index < TagCount; ++index) {
+			auto& counters = slots[index];
+			// the next frame's peak starts from what is held now
+			lastFrame[index] = Counters{ counters.frameAllocations.exchange(0, std::memory_order_relaxed),
+																	 counters.frameFrees.exchange(0, std::memory_order_relaxed),
+																	 counters.frameBytes.exchange(0, std::memory_order_relaxed),
+																	 counters.live.load(std::memory_order_relaxed),
+																	 counters.framePeak.exchange(counters.live.load(std::memory_order_relaxed),
+																															 std::memory_order_relaxed) };
+		}
+		++frames;
+	}
+
+	Report report() {
+		Report result;
+		std::scoped_lock lock{ frameMutex };
+		for (std::size_t index = 0; index < TagCount; ++index) {
+			result.tags[index] = TagReport{ collect(slots[index]), lastFrame[index] };
+		}
+		result.frames = frames;
+		return result;
+	}
+
+	void printInfo() {
+		const auto snapshot = report();
+		spdlog::info("Heap allocations over {} frames:", snapshot.frames);
+		for (std::size_t index = 0; index < TagCount; ++index) {
+			const auto& total = snapshot.tags[index].total;
+			if (total.allocations == 0) { continue; }
+			spdlog::info("  {}: {} allocations, {} bytes, {} per frame, peak {} bytes, {} bytes still held",
+									 TagNames[index],
+									 total.allocations,
+									 total.bytes,
+									 snapshot.frames == 0 ? 0 : total.allocations / snapshot.frames,
+									 total.peak,
+									 total.live);
+		}
+	}
+}// namespace game::alloc
+
+void* operator new(const std::size_t size) {
+	return game::alloc::allocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new[](const std::size_t size) {
+	return game::alloc::allocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment) {
+	return game::alloc::allocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](const std::size_t size, const std::align_val_t alignment) {
+	return game::alloc::allocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(const std::size_t size, const std::nothrow_t& /*unused*/) noexcept {
+	return game::alloc::allocateOrNull(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new[](const std::size_t size, const std::nothrow_t& /*unused*/) noexcept {
+	return game::alloc::allocateOrNull(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment, const std::nothrow_t& /*unused*/) noexcept {
+	return game::alloc::allocateOrNull(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](const std::size_t size, const std::align_val_t alignment, const std::nothrow_t& /*unused*/) noexcept {
+	return game::alloc::allocateOrNull(size, static_cast<std::size_t>(alignment));
+}
+
+// The header knows size and offset, the sized and aligned forms all end up in the same place
+void operator delete(void* pointer) noexcept {
+	game::alloc::deallocate(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+	game::alloc::deallocate(pointer);
+}
+
+void operator delete(void* pointer, const std::size_t /*size*/) noexcept {
+	game::alloc::deallocate(pointer);
+}
+
+void operator delete[](void* pointer, const std::size_t /*size*/) noexcept {
+	game::alloc::deallocate(pointer);
+}
+
+void operator delete(void* pointer, const std::align_val_t /*alignment*/) noexcept {
+	game::alloc::deallocate(pointer);
+}
+
+void operator delete[](void* pointer, const std::align_val_t /*alignment*/) noexcept {
+	game::alloc::deallocate(pointer);
+}
+
+void operator delete(void* pointer, const std::size_t /*size*/, const std::align_val_t /*alignment*/) noexcept {
+	game::alloc::deallocate(pointer);
+}
+
+void operator delete[](void* pointer, const std::size_t /*size*/, const std::align_val_t /*alignment*/) noexcept {
+	game::alloc::deallocate(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t& /*unused*/) noexcept {
+	game::alloc::deallocate(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t& /*unused*/) noexcept {
+	game::alloc::deallocate(pointer);
+}
+
+void operator delete(void* pointer, const std::align_val_t /*alignment*/, const std::nothrow_t& /*unused*/) noexcept {
+	game::alloc::deallocate(pointer);
+}
+
+void operator delete[](void* pointer, const std::align_val_t /*alignment*/, const std::nothrow_t& /*unused*/) noexcept {
+	game::alloc::deallocate(pointer);
+}
+#endif
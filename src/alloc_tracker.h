@@ -0,0 +1,90 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Heap allocation accounting per subsystem. With GAME_ALLOC_TRACKING defined (Debug builds) the global operator new
+// and delete are replaced and every allocation is charged to the tag of the innermost scope on the allocating thread.
+// Without it the scopes are empty and nothing is replaced.
+namespace game::alloc {
+
+	enum class Tag : std::uint8_t { Untagged, Input, Simulation, Recorder, Serialize, Replay, Render, Logging, Count };
+
+	constexpr std::size_t TagCount = static_cast<std::size_t>(Tag::Count);
+
+	constexpr std::array<std::string_view, TagCount> TagNames{
+		"untagged", "input", "simulation", "recorder", "serialize", "replay", "render", "logging"
+	};
+
+	constexpr std::string_view toString(const Tag tag) {
+		return TagNames.at(static_cast<std::size_t>(tag));
+	}
+
+	struct Counters {
+		std::uint64_t allocations = 0;
+		std::uint64_t frees				= 0;
+		std::uint64_t bytes				= 0;
+		// bytes still held, a block is charged to the tag it was allocated under even if freed under another one
+		std::uint64_t live = 0;
+		std::uint64_t peak = 0;
+	};
+
+	struct TagReport {
+		Counters total;
+		// the last frame closed with endFrame, its peak is the highest live value seen during that frame
+		Counters frame;
+	};
+
+	struct Report {
+		std::array<TagReport, TagCount> tags{};
+		std::uint64_t										frames = 0;
+	};
+
+#ifdef GAME_ALLOC_TRACKING
+	constexpr bool Enabled = true;
+
+	[[nodiscard]] Tag currentTag();
+
+	class Scope {
+	private:
+		Tag _previous;
+
+	public:
+		explicit Scope(Tag tag);
+		~Scope();
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+	};
+
+	// Closes the counters of the current frame, call it once per frame from one thread
+	void endFrame();
+
+	[[nodiscard]] Report report();
+
+	void printInfo();
+
+#define GAME_ALLOC_CONCAT_IMPL(a, b) a##b
+#define GAME_ALLOC_CONCAT(a, b) GAME_ALLOC_CONCAT_IMPL(a, b)
+#define GAME_ALLOC_SCOPE(tag) const game::alloc::Scope GAME_ALLOC_CONCAT(allocScope, __LINE__){ game::alloc::Tag::tag }
+#else
+	constexpr bool Enabled = false;
+
+	[[nodiscard]] constexpr Tag currentTag() {
+		return Tag::Untagged;
+	}
+
+	class Scope {
+	public:
+		constexpr explicit Scope(Tag /*tag*/) {}
+	};
+
+	constexpr void endFrame() {}
+
+	constexpr void printInfo() {}
+
+#define GAME_ALLOC_SCOPE(tag) static_cast<void>(0)
+#endif
+
+}// namespace game::alloc
@@ -0,0 +1,26 @@
+#pragma once
+
+namespace game {
+	struct Position {
+		float x;
+		float y;
+	};
+
+	// Units per second
+	struct Velocity {
+		float x;
+		float y;
+	};
+
+	// Axis aligned box around Position, what the mouse can hover and select
+	struct Shape {
+		float halfWidth;
+		float halfHeight;
+	};
+
+	// Entities steered by the local player's actions
+	struct PlayerControlled {
+		float speed;
+	};
+
+}// namespace game
@@ -0,0 +1,78 @@
+#include "device_backend.h"
+#include <utility>
+
+namespace game {
+	void SfmlDeviceBackend::update() {
+		sf::Joystick::update();
+	}
+
+	bool SfmlDeviceBackend::isConnected(unsigned int id) const {
+		return sf::Joystick::isConnected(id);
+	}
+
+	std::string SfmlDeviceBackend::name(unsigned int id) const {
+		return static_cast<std::string>(sf::Joystick::getIdentification(id).name);
+	}
+
+	unsigned int SfmlDeviceBackend::buttonCount(unsigned int id) const {
+		return sf::Joystick::getButtonCount(id);
+	}
+
+	bool SfmlDeviceBackend::isButtonPressed(unsigned int id, unsigned int button) const {
+		return sf::Joystick::isButtonPressed(id, button);
+	}
+
+	float SfmlDeviceBackend::axisPosition(unsigned int id, sf::Joystick::Axis axis) const {
+		return sf::Joystick::getAxisPosition(id, axis);
+	}
+
+	void FakeDeviceBackend::connect(unsigned int id, std::string name, unsigned int buttonCount) {
+		std::scoped_lock lock{ _mutex };
+		_pending.at(id) = Device{ true, std::move(name), buttonCount, {}, {} };
+	}
+
+	void FakeDeviceBackend::disconnect(unsigned int id) {
+		std::scoped_lock lock{ _mutex };
+		_pending.at(id) = Device{};
+	}
+
+	void FakeDeviceBackend::setButton(unsigned int id, unsigned int button, bool pressed) {
+		std::scoped_lock lock{ _mutex };
+		_pending.at(id).buttonState.at(button) = pressed;
+	}
+
+	void FakeDeviceBackend::setAxis(unsigned int id, sf::Joystick::Axis axis, float position) {
+		std::scoped_lock lock{ _mutex };
+		_pending.at(id).axisPosition.at(static_cast<std::size_t>(axis)) = position;
+	}
+
+	void FakeDeviceBackend::update() {
+		std::scoped_lock lock{ _mutex };
+		_current = _pending;
+	}
+
+	bool FakeDeviceBackend::isConnected(unsigned int id) const {
+		std::scoped_lock lock{ _mutex };
+		return _current.at(id).connected;
+	}
+
+	std::string FakeDeviceBackend::name(unsigned int id) const {
+		std::scoped_lock lock{ _mutex };
+		return _current.at(id).name;
+	}
+
+	unsigned int FakeDeviceBackend::buttonCount(unsigned int id) const {
+		std::scoped_lock lock{ _mutex };
+		return _current.at(id).buttonCount;
+	}
+
+	bool FakeDeviceBackend::isButtonPressed(unsigned int id, unsigned int button) const {
+		std::scoped_lock lock{ _mutex };
+		return _current.at(id).buttonState.at(button);
+	}
+
+	float FakeDeviceBackend::axisPosition(unsigned int id, sf::Joystick::Axis axis) const {
+		std::scoped_lock lock{ _mutex };
+		return _current.at(id).axisPosition.at(static_cast<std::size_t>(axis));
+	}
+}// namespace game
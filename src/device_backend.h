@@ -0,0 +1,64 @@
+#pragma once
+#include <SFML/Window/Joystick.hpp>
+#include <array>
+#include <mutex>
+#include <string>
+
+namespace game {
+
+	// Source of raw device state. update() refreshes the backend's cached state, the queries read that cache.
+	class DeviceBackend {
+	public:
+		virtual ~DeviceBackend() = default;
+
+		virtual void															update()																									 = 0;
+		[[nodiscard]] virtual bool								isConnected(unsigned int id) const												 = 0;
+		[[nodiscard]] virtual std::string					name(unsigned int id) const																 = 0;
+		[[nodiscard]] virtual unsigned int				buttonCount(unsigned int id) const												 = 0;
+		[[nodiscard]] virtual bool								isButtonPressed(unsigned int id, unsigned int button) const = 0;
+		[[nodiscard]] virtual float								axisPosition(unsigned int id, sf::Joystick::Axis axis) const = 0;
+	};
+
+	// SFML also refreshes its joystick state from inside Window::pollEvent, so this backend has to be polled on the
+	// thread that pumps the window's events
+	class SfmlDeviceBackend : public DeviceBackend {
+	public:
+		void											update() override;
+		[[nodiscard]] bool				isConnected(unsigned int id) const override;
+		[[nodiscard]] std::string name(unsigned int id) const override;
+		[[nodiscard]] unsigned int buttonCount(unsigned int id) const override;
+		[[nodiscard]] bool				isButtonPressed(unsigned int id, unsigned int button) const override;
+		[[nodiscard]] float				axisPosition(unsigned int id, sf::Joystick::Axis axis) const override;
+	};
+
+	// Scriptable backend for tests and benchmarks. Changes become visible to queries on the next update().
+	class FakeDeviceBackend : public DeviceBackend {
+	public:
+		struct Device {
+			bool																				connected = false;
+			std::string																	name;
+			unsigned int																buttonCount = 0;
+			std::array<bool, sf::Joystick::ButtonCount> buttonState{};
+			std::array<float, sf::Joystick::AxisCount>	axisPosition{};
+		};
+
+	private:
+		mutable std::mutex															_mutex;
+		std::array<Device, sf::Joystick::Count> _pending{};
+		std::array<Device, sf::Joystick::Count> _current{};
+
+	public:
+		void connect(unsigned int id, std::string name, unsigned int buttonCount);
+		void disconnect(unsigned int id);
+		void setButton(unsigned int id, unsigned int button, bool pressed);
+		void setAxis(unsigned int id, sf::Joystick::Axis axis, float position);
+
+		void											update() override;
+		[[nodiscard]] bool				isConnected(unsigned int id) const override;
+		[[nodiscard]] std::string name(unsigned int id) const override;
+		[[nodiscard]] unsigned int buttonCount(unsigned int id) const override;
+		[[nodiscard]] bool				isButtonPressed(unsigned int id, unsigned int button) const override;
+		[[nodiscard]] float				axisPosition(unsigned int id, sf::Joystick::Axis axis) const override;
+	};
+
+}// namespace game
@@ -0,0 +1,83 @@
+#include "device_manager.h"
+#include <algorithm>
+
+namespace game {
+	DeviceManager::DeviceManager(std::unique_ptr<DeviceBackend> backend)
+		: _backend{ std::move(backend) } {}
+
+	void appendEvents(const DeviceSnapshot& from, const DeviceSnapshot& to, EventList& events) {
+		static const DeviceState idle{};
+		for (unsigned int id = 0; id < sf::Joystick::Count; ++id) {
+			const auto* before = &from.joysticks.at(id);
+			const auto& after	 = to.joysticks.at(id);
+			if (before->connectionCount != after.connectionCount) {
+				if (before->connected) { events.emplace_back(Disconnected<JoystickDevice>{ { id, 0 } }); }
+				if (after.connected) { events.emplace_back(Connected<JoystickDevice>{ { id, after.buttonCount } }); }
+				before = &idle;
+			}
+			if (!after.connected) { continue; }
+
+			for (unsigned int button = 0; button < after.buttonCount; ++button) {
+				if (before->buttonState.at(button) == after.buttonState.at(button)) { continue; }
+				if (after.buttonState.at(button)) {
+					events.emplace_back(Pressed<JoystickButton>{ { id, button } });
+				} else {
+					events.emplace_back(Released<JoystickButton>{ { id, button } });
+				}
+			}
+			for (unsigned int axis = 0; axis < sf::Joystick::AxisCount; ++axis) {
+				const auto position = after.axisPosition.at(axis);
+				if (before->axisPosition.at(axis) != position) {
+					events.emplace_back(Moved<JoystickAxis>{ { id, axis, position } });
+				}
+			}
+		}
+	}
+
+	void DeviceManager::start(Clock::duration interval) {
+		_thread = std::jthread{ [this, interval](const std::stop_token& stop) {
+			auto next = Clock::now();
+			while (!stop.stop_requested()) {
+				pollOnce();
+				next += interval;
+				std::this_thread::sleep_until(next);
+			}
+		} };
+	}
+
+	void DeviceManager::pollOnce() {
+		_backend->update();
+
+		for (unsigned int id = 0; id < sf::Joystick::Count; ++id) {
+			auto&			 js				= _working.joysticks.at(id);
+			const bool connected = _backend->isConnected(id);
+			if (connected != js.connected) {
+				js.connected = connected;
+				++js.connectionCount;
+				js.name				 = connected ? _backend->name(id) : std::string{};
+				js.buttonCount = connected ? std::min<unsigned int>(_backend->buttonCount(id), sf::Joystick::ButtonCount) : 0;
+				js.buttonState.fill(false);
+				js.axisPosition.fill(0.f);
+			}
+			if (!connected) { continue; }
+
+			for (unsigned int button = 0; button < js.buttonCount; ++button) {
+				js.buttonState.at(button) = _backend->isButtonPressed(id, button);
+			}
+			for (unsigned int axis = 0; axis < sf::Joystick::AxisCount; ++axis) {
+				js.axisPosition.at(axis) = _backend->axisPosition(id, static_cast<sf::Joystick::Axis>(axis));
+			}
+		}
+		++_working.sequence;
+
+		_snapshots.back() = _working;
+		_snapshots.publish();
+	}
+
+	void DeviceManager::pollEvents(EventList& events) {
+		if (!_thread.joinable()) { pollOnce(); }
+		if (!refresh()) { return; }
+		appendEvents(_seen, current(), events);
+		_seen = current();
+	}
+}// namespace game
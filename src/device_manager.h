@@ -0,0 +1,101 @@
+#pragma once
+#include "device_backend.h"
+#include "event.h"
+#include <SFML/Window/Joystick.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace game {
+
+	struct DeviceState {
+		bool																				connected = false;
+		// incremented on every connect and disconnect, so readers can not miss a replug between two snapshots
+		std::uint32_t																connectionCount = 0;
+		std::string																	name;
+		unsigned int																buttonCount = 0;
+		std::array<bool, sf::Joystick::ButtonCount> buttonState{};
+		std::array<float, sf::Joystick::AxisCount>	axisPosition{};
+	};
+
+	struct DeviceSnapshot {
+		std::uint64_t																 sequence = 0;
+		std::array<DeviceState, sf::Joystick::Count> joysticks{};
+	};
+
+	// Single producer, single consumer hand off: neither side ever waits for the other
+	template<typename T>
+	class TripleBuffer {
+	private:
+		static constexpr std::uint8_t IndexMask = 0x3U;
+		static constexpr std::uint8_t Dirty			= 0x4U;
+
+		std::array<T, 3>					_buffers{};
+		std::atomic<std::uint8_t> _middle{ 1 };
+		std::uint8_t							_back	 = 0;
+		std::uint8_t							_front = 2;
+
+	public:
+		// producer side
+		[[nodiscard]] T& back() {
+			return _buffers[_back];
+		}
+
+		void publish() {
+			_back = static_cast<std::uint8_t>(_middle.exchange(static_cast<std::uint8_t>(_back | Dirty), std::memory_order_acq_rel) & IndexMask);
+		}
+
+		// consumer side, returns true if a newer value became the front
+		bool update() {
+			if ((_middle.load(std::memory_order_relaxed) & Dirty) == 0) { return false; }
+			_front = static_cast<std::uint8_t>(_middle.exchange(_front, std::memory_order_acq_rel) & IndexMask);
+			return true;
+		}
+
+		[[nodiscard]] const T& front() const {
+			return _buffers[_front];
+		}
+	};
+
+	// Appends the events that turn the joysticks of from into those of to. A replug between the two snapshots shows as
+	// Disconnected followed by Connected, the new connection starts from released buttons and centered axes.
+	void appendEvents(const DeviceSnapshot& from, const DeviceSnapshot& to, EventList& events);
+
+	// Polls every device in one pass and publishes snapshots to the game loop. The game polls from the loop itself,
+	// pollEvents() once per tick, because its SFML backend must not be read from another thread. The background thread
+	// of start() is for thread safe backends only, in this tree that is the fake one of the tests and benchmarks.
+	class DeviceManager {
+	private:
+		std::unique_ptr<DeviceBackend> _backend;
+		DeviceSnapshot								 _working;
+		TripleBuffer<DeviceSnapshot>	 _snapshots;
+		// what the game has been told about so far
+		DeviceSnapshot _seen;
+		std::jthread	 _thread;
+
+	public:
+		explicit DeviceManager(std::unique_ptr<DeviceBackend> backend);
+
+		// Starts background polling, pollOnce() must not be called afterwards. Never with SfmlDeviceBackend, see above.
+		void start(Clock::duration interval = std::chrono::milliseconds{ 4 });
+
+		void pollOnce();
+
+		// Game loop side: polls unless a background thread does, and appends what changed since the last call as events
+		void pollEvents(EventList& events);
+
+		// Game loop side: picks up the newest snapshot if there is one, never blocks
+		bool refresh() {
+			return _snapshots.update();
+		}
+
+		[[nodiscard]] const DeviceSnapshot& current() const {
+			return _snapshots.front();
+		}
+	};
+
+}// namespace game
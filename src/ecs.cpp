@@ -0,0 +1,177 @@
+#include "ecs.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <stdexcept>
+
+namespace game {
+	namespace detail {
+		namespace {
+			std::array<ComponentInfo, MaxComponents> componentInfos{};
+			std::atomic<std::size_t>								 componentCount{ 0 };
+		}// namespace
+
+		std::size_t registerComponent(const ComponentInfo info) {
+			const auto id = componentCount.fetch_add(1);
+			if (id >= MaxComponents) { throw std::length_error("Too many component types"); }
+			componentInfos.at(id) = info;
+			return id;
+		}
+
+		const ComponentInfo& componentInfo(const std::size_t id) {
+			return componentInfos.at(id);
+		}
+	}// namespace detail
+
+	namespace {
+		constexpr std::size_t alignUp(const std::size_t value, const std::size_t alignment) {
+			return (value + alignment - 1) / alignment * alignment;
+		}
+	}// namespace
+
+	Archetype::Archetype(const ComponentMask mask)
+		: _mask{ mask } {
+		std::size_t rowBytes = sizeof(Entity);
+		for (std::size_t id = 0; id < MaxComponents; ++id) {
+			if (!mask.test(id)) { continue; }
+			_componentIds.push_back(id);
+			rowBytes += detail::componentInfo(id).size;
+		}
+
+		// columns are laid out one after another, each aligned for its type
+		for (_capacity = std::max<std::size_t>(1, ChunkBytes / rowBytes);; --_capacity) {
+			std::size_t offset = sizeof(Entity) * _capacity;
+			for (const auto id : _componentIds) {
+				const auto& info = detail::componentInfo(id);
+				offset					 = alignUp(offset, info.alignment);
+				_offsets.at(id)	 = offset;
+				offset += info.size * _capacity;
+			}
+			_bytes = offset;
+			if (_bytes <= ChunkBytes || _capacity == 1) { break; }
+		}
+	}
+
+	std::pair<std::size_t, std::size_t> Archetype::append(const Entity entity) {
+		if (_chunks.empty() || _chunks.back().count == _capacity) { _chunks.push_back(Chunk{ std::vector<std::byte>(_bytes), 0 }); }
+
+		auto&			 chunk = _chunks.back();
+		const auto row	 = chunk.count++;
+		entities(chunk)[row] = entity;
+		for (const auto id : _componentIds) {
+			const auto size = detail::componentInfo(id).size;
+			std::memset(column(chunk, id) + row * size, 0, size);
+		}
+		return { _chunks.size() - 1, row };
+	}
+
+	std::optional<Entity> Archetype::erase(const std::size_t chunkIndex, const std::size_t row) {
+		auto&			 last		 = _chunks.back();
+		const auto lastRow = last.count - 1;
+		auto&			 chunk	 = _chunks.at(chunkIndex);
+
+		std::optional<Entity> moved;
+		if (&chunk != &last || row != lastRow) {
+			moved							 = entities(last)[lastRow];
+			entities(chunk)[row] = *moved;
+			for (const auto id : _componentIds) {
+				const auto size = detail::componentInfo(id).size;
+				std::memcpy(column(chunk, id) + row * size, column(last, id) + lastRow * size, size);
+			}
+		}
+
+		if (--last.count == 0) { _chunks.pop_back(); }
+		return moved;
+	}
+
+	std::size_t World::archetypeFor(const ComponentMask& mask) {
+		if (const auto found = _archetypeIndex.find(mask); found != _archetypeIndex.end()) { return found->second; }
+		_archetypes.emplace_back(mask);
+		_archetypeIndex.emplace(mask, _archetypes.size() - 1);
+		return _archetypes.size() - 1;
+	}
+
+	Entity World::allocate() {
+		if (_freeIndices.empty()) {
+			_locations.emplace_back();
+			return Entity{ static_cast<std::uint32_t>(_locations.size() - 1), 0 };
+		}
+		const auto index = _freeIndices.back();
+		_freeIndices.pop_back();
+		return Entity{ index, _locations[index].generation };
+	}
+
+	void World::place(const Entity entity, const std::size_t archetype) {
+		const auto [chunk, row] = _archetypes[archetype].append(entity);
+		_locations[entity.index] = Location{ static_cast<std::uint32_t>(archetype),
+																				 static_cast<std::uint32_t>(chunk),
+																				 static_cast<std::uint32_t>(row),
+																				 entity.generation,
+																				 true };
+		++_size;
+	}
+
+	void World::relocate(const Entity entity, const ComponentMask& mask) {
+		if (!alive(entity)) { return; }
+		const auto from				 = _locations[entity.index];
+		const auto archetype	 = archetypeFor(mask);
+		auto&			 source			 = _archetypes[from.archetype];
+		auto&			 sourceChunk = source.chunks()[from.chunk];
+		const auto [chunk, row] = _archetypes[archetype].append(entity);
+
+		auto& target = _archetypes[archetype];
+		for (const auto id : target.componentIds()) {
+			if (!source.mask().test(id)) { continue; }
+			const auto size = detail::componentInfo(id).size;
+			std::memcpy(target.column(target.chunks()[chunk], id) + row * size, source.column(sourceChunk, id) + from.row * size, size);
+		}
+
+		if (const auto moved = source.erase(from.chunk, from.row)) {
+			_locations[moved->index].chunk = from.chunk;
+			_locations[moved->index].row	 = from.row;
+		}
+		_locations[entity.index] = Location{ static_cast<std::uint32_t>(archetype),
+																				 static_cast<std::uint32_t>(chunk),
+																				 static_cast<std::uint32_t>(row),
+																				 entity.generation,
+																				 true };
+		structuralChange(entity);
+	}
+
+	std::byte* World::find(const Entity entity, const std::size_t id) {
+		if (!alive(entity)) { return nullptr; }
+		const auto& location	= _locations[entity.index];
+		auto&				archetype = _archetypes[location.archetype];
+		if (!archetype.mask().test(id)) { return nullptr; }
+		return archetype.column(archetype.chunks()[location.chunk], id) + location.row * detail::componentInfo(id).size;
+	}
+
+	void World::destroy(const Entity entity) {
+		if (!alive(entity)) { return; }
+		auto& location = _locations[entity.index];
+		if (const auto moved = _archetypes[location.archetype].erase(location.chunk, location.row)) {
+			_locations[moved->index].chunk = location.chunk;
+			_locations[moved->index].row	 = location.row;
+		}
+		location.alive = false;
+		++location.generation;
+		_freeIndices.push_back(entity.index);
+		--_size;
+		structuralChange(entity);
+	}
+
+	bool World::alive(const Entity entity) const {
+		return entity.index < _locations.size() && _locations[entity.index].alive
+					 && _locations[entity.index].generation == entity.generation;
+	}
+
+	std::vector<ChunkView> World::chunks(const ComponentMask& required) {
+		std::vector<ChunkView> result;
+		for (auto& archetype : _archetypes) {
+			if ((archetype.mask() & required) != required) { continue; }
+			for (auto& chunk : archetype.chunks()) { result.emplace_back(archetype, chunk); }
+		}
+		return result;
+	}
+
+}// namespace game
@@ -0,0 +1,255 @@
+#pragma once
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace game {
+
+	struct Entity {
+		std::uint32_t index			 = 0;
+		std::uint32_t generation = 0;
+
+		constexpr bool operator==(const Entity&) const = default;
+	};
+
+	constexpr std::size_t MaxComponents = 64;
+	using ComponentMask									= std::bitset<MaxComponents>;
+
+	// Components are plain data: chunks move them with memcpy and a World is copied byte for byte
+	template<typename T>
+	concept Component = std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T> && !std::is_const_v<T>
+											&& alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+	namespace detail {
+		struct ComponentInfo {
+			std::size_t size;
+			std::size_t alignment;
+		};
+
+		std::size_t					 registerComponent(ComponentInfo info);
+		const ComponentInfo& componentInfo(std::size_t id);
+	}// namespace detail
+
+	// Ids are handed out on first use and are only stable within one run
+	template<Component T>
+	std::size_t componentId() {
+		static const std::size_t id = detail::registerComponent({ sizeof(T), alignof(T) });
+		return id;
+	}
+
+	template<Component... Ts>
+	ComponentMask componentMask() {
+		ComponentMask mask;
+		(mask.set(componentId<Ts>()), ...);
+		return mask;
+	}
+
+	// All entities with exactly the same set of components. Rows live in fixed size chunks,
+	// every chunk holds one contiguous column per component plus a column of entity ids.
+	class Archetype {
+	public:
+		static constexpr std::size_t ChunkBytes = 16 * 1024;
+
+		struct Chunk {
+			std::vector<std::byte> data;
+			std::size_t						 count = 0;
+		};
+
+	private:
+		ComponentMask															_mask;
+		std::vector<std::size_t>									_componentIds;
+		std::array<std::size_t, MaxComponents>		_offsets{};
+		std::size_t																_capacity = 0;
+		std::size_t																_bytes		= 0;
+		std::vector<Chunk>												_chunks;
+
+	public:
+		explicit Archetype(ComponentMask mask);
+
+		[[nodiscard]] const ComponentMask& mask() const {
+			return _mask;
+		}
+
+		[[nodiscard]] const std::vector<std::size_t>& componentIds() const {
+			return _componentIds;
+		}
+
+		[[nodiscard]] std::size_t capacity() const {
+			return _capacity;
+		}
+
+		[[nodiscard]] std::vector<Chunk>& chunks() {
+			return _chunks;
+		}
+
+		[[nodiscard]] std::byte* column(Chunk& chunk, std::size_t id) const {
+			return chunk.data.data() + _offsets[id];
+		}
+
+		[[nodiscard]] const std::byte* column(const Chunk& chunk, std::size_t id) const {
+			return chunk.data.data() + _offsets[id];
+		}
+
+		[[nodiscard]] Entity* entities(Chunk& chunk) const {
+			return reinterpret_cast<Entity*>(chunk.data.data());
+		}
+
+		// Appends a zero initialized row, returns chunk index and row
+		std::pair<std::size_t, std::size_t> append(Entity entity);
+
+		// Fills the hole with the very last row to keep chunks dense, returns the entity that moved into it
+		std::optional<Entity> erase(std::size_t chunkIndex, std::size_t row);
+	};
+
+	// Rows of one chunk that hold at least the requested components
+	class ChunkView {
+	private:
+		const Archetype*	_archetype;
+		Archetype::Chunk* _chunk;
+
+	public:
+		ChunkView(const Archetype& archetype, Archetype::Chunk& chunk)
+			: _archetype{ &archetype }
+			, _chunk{ &chunk } {}
+
+		[[nodiscard]] std::size_t size() const {
+			return _chunk->count;
+		}
+
+		template<Component T>
+		[[nodiscard]] bool has() const {
+			return _archetype->mask().test(componentId<T>());
+		}
+
+		template<Component T>
+		[[nodiscard]] std::span<T> column() const {
+			return { reinterpret_cast<T*>(_archetype->column(*_chunk, componentId<T>())), _chunk->count };
+		}
+
+		[[nodiscard]] std::span<const Entity> entities() const {
+			return { _archetype->entities(*_chunk), _chunk->count };
+		}
+	};
+
+	// Entity store with archetype grouped, chunked component storage. Copying a World copies every component.
+	// Structural changes (create, destroy, add, remove) must not overlap with iteration.
+	class World {
+	private:
+		struct Location {
+			std::uint32_t archetype	 = 0;
+			std::uint32_t chunk			 = 0;
+			std::uint32_t row				 = 0;
+			std::uint32_t generation = 0;
+			bool					alive			 = false;
+		};
+
+		std::vector<Archetype>										 _archetypes;
+		std::unordered_map<ComponentMask, std::size_t> _archetypeIndex;
+		std::vector<Location>											 _locations;
+		std::vector<std::uint32_t>								 _freeIndices;
+		std::size_t																 _size = 0;
+		std::vector<Entity>												 _structuralChanges;
+		bool																			 _trackStructuralChanges = false;
+
+		std::size_t archetypeFor(const ComponentMask& mask);
+		Entity			allocate();
+		void				place(Entity entity, std::size_t archetype);
+		void				relocate(Entity entity, const ComponentMask& mask);
+		[[nodiscard]] std::byte* find(Entity entity, std::size_t id);
+
+		void structuralChange(const Entity entity) {
+			if (_trackStructuralChanges) { _structuralChanges.push_back(entity); }
+		}
+
+		template<Component T>
+		void write(Entity entity, const T& value) {
+			std::memcpy(find(entity, componentId<T>()), &value, sizeof(T));
+		}
+
+	public:
+		template<Component... Ts>
+		Entity create(const Ts&... components) {
+			const auto entity = allocate();
+			place(entity, archetypeFor(componentMask<Ts...>()));
+			(write(entity, components), ...);
+			structuralChange(entity);
+			return entity;
+		}
+
+		void destroy(Entity entity);
+
+		[[nodiscard]] bool alive(Entity entity) const;
+
+		[[nodiscard]] std::size_t size() const {
+			return _size;
+		}
+
+		[[nodiscard]] std::size_t archetypeCount() const {
+			return _archetypes.size();
+		}
+
+		template<Component T>
+		[[nodiscard]] T* get(Entity entity) {
+			return reinterpret_cast<T*>(find(entity, componentId<T>()));
+		}
+
+		template<Component T>
+		[[nodiscard]] const T* get(Entity entity) const {
+			return const_cast<World&>(*this).get<T>(entity);
+		}
+
+		// Adds the component or overwrites it if the entity already has one
+		template<Component T>
+		void add(Entity entity, const T& value) {
+			if (!alive(entity)) { return; }
+			auto mask = _archetypes.at(_locations.at(entity.index).archetype).mask();
+			if (!mask.test(componentId<T>())) { relocate(entity, mask.set(componentId<T>())); }
+			write(entity, value);
+		}
+
+		template<Component T>
+		void remove(Entity entity) {
+			if (!alive(entity)) { return; }
+			auto mask = _archetypes.at(_locations.at(entity.index).archetype).mask();
+			if (mask.test(componentId<T>())) { relocate(entity, mask.reset(componentId<T>())); }
+		}
+
+		// While enabled, every entity that is created, destroyed or gets a different set of components is listed until
+		// the list is cleared. Entities can be listed more than once, destroyed ones with the generation they had.
+		void trackStructuralChanges(const bool enabled) {
+			_trackStructuralChanges = enabled;
+		}
+
+		[[nodiscard]] const std::vector<Entity>& structuralChanges() const {
+			return _structuralChanges;
+		}
+
+		void clearStructuralChanges() {
+			_structuralChanges.clear();
+		}
+
+		// Every chunk whose archetype has all components in required
+		[[nodiscard]] std::vector<ChunkView> chunks(const ComponentMask& required);
+
+		template<Component... Ts, typename Function>
+		void each(Function&& function) {
+			for (const auto& chunk : chunks(componentMask<Ts...>())) {
+				std::apply(
+					[&](auto... columns) {
+						for (std::size_t row = 0; row < chunk.size(); ++row) { function(columns[row]...); }
+					},
+					std::tuple{ chunk.template column<Ts>()... });
+			}
+		}
+	};
+
+}// namespace game
@@ -3,6 +3,7 @@
 #include <SFML/Window/Keyboard.hpp>
 #include <array>
 #include <chrono>
+#include <cstdint>
 #include <string_view>
 #include <variant>
 #include <vector>
@@ -21,6 +22,10 @@ namespace game {
 		Clock::duration										elapsed;
 	};
 
+	// Length of one simulation step. The game state cuts elapsed time into steps of this length, so it does not depend
+	// on how the time was split between TimeElapsed events.
+	constexpr Clock::duration TickDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds{ 1'000'000'000 / 60 });
+
 	template<typename Source>
 	struct Pressed {
 		constexpr static std::string_view name{ "Pressed" };
@@ -41,6 +46,28 @@ namespace game {
 		Source														source;
 	};
 
+	template<typename Source>
+	struct Connected {
+		constexpr static std::string_view name{ "Connected" };
+		constexpr static auto							elements = std::to_array<std::string_view>({ "source" });
+		Source														source;
+	};
+
+	template<typename Source>
+	struct Disconnected {
+		constexpr static std::string_view name{ "Disconnected" };
+		constexpr static auto							elements = std::to_array<std::string_view>({ "source" });
+		Source														source;
+	};
+
+	// Joystick slot as seen on connect, buttonCount is zero in disconnect events
+	struct JoystickDevice {
+		constexpr static std::string_view name{ "JoystickDevice" };
+		constexpr static auto							elements = std::to_array<std::string_view>({ "id", "buttonCount" });
+		unsigned int											id;
+		unsigned int											buttonCount;
+	};
+
 	struct JoystickButton {
 		constexpr static std::string_view name{ "JoystickButton" };
 		constexpr static auto							elements = std::to_array<std::string_view>({ "id", "button" });
@@ -69,6 +96,14 @@ namespace game {
 		Mouse															mouse;
 	};
 
+	// Hash of the simulation state after the tick with the given number, embedded in recordings to verify replays
+	struct Checkpoint {
+		constexpr static std::string_view name{ "Checkpoint" };
+		constexpr static auto							elements = std::to_array<std::string_view>({ "tick", "hash" });
+		std::uint32_t											tick;
+		std::uint64_t											hash;
+	};
+
 	struct Key {
 		constexpr static std::string_view name{ "Key" };
 		constexpr static auto elements = std::to_array<std::string_view>({ "alt", "control", "system", "shift", "key" });
@@ -78,8 +113,15 @@ namespace game {
 
 
 	template<typename T>
-	concept JoystickEvent =
-		std::is_same_v<T, Pressed<JoystickButton>> || std::is_same_v<T, Released<JoystickButton>> || std::is_same_v<T, Moved<JoystickAxis>>;
+	concept JoystickEvent = std::is_same_v<T, Pressed<JoystickButton>> || std::is_same_v<T, Released<JoystickButton>>
+													|| std::is_same_v<T, Moved<JoystickAxis>> || std::is_same_v<T, Connected<JoystickDevice>>
+													|| std::is_same_v<T, Disconnected<JoystickDevice>>;
+
+	template<typename T>
+	concept KeyEvent = std::is_same_v<T, Pressed<Key>> || std::is_same_v<T, Released<Key>>;
+
+	template<typename T>
+	concept MouseButtonEvent = std::is_same_v<T, Pressed<MouseButton>> || std::is_same_v<T, Released<MouseButton>>;
 
 	using Event = std::variant<std::monostate,
 														 Pressed<JoystickButton>,
@@ -91,7 +133,10 @@ namespace game {
 														 Pressed<MouseButton>,
 														 Released<MouseButton>,
 														 CloseWindow,
-														 TimeElapsed>;
+														 TimeElapsed,
+														 Checkpoint,
+														 Connected<JoystickDevice>,
+														 Disconnected<JoystickDevice>>;
 
 	struct EventList : public std::vector<Event> {
 		EventList(std::initializer_list<Event> init)
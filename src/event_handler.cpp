@@ -1,34 +1,91 @@
 #include "event_handler.h"
+#include "alloc_tracker.h"
+#include "device_manager.h"
 #include "render.h"
 #include "utility.h"
+#include <spdlog/spdlog.h>
 #include <thread>
+#include <utility>
 namespace game {
+	namespace {
+		// A wait longer than this shows frames meanwhile, shorter ones are left to the pacer alone
+		constexpr Clock::duration IdleFrameThreshold = std::chrono::milliseconds{ 34 };
+		constexpr Clock::duration IdleFrameInterval	 = std::chrono::microseconds{ 16'667 };
+		// Longest live TimeElapsed. Time lost to a longer stall is dropped instead of caught up, which would make the
+		// next frame slow as well. The recording holds the capped value, so replays take the same steps.
+		constexpr int							MaxCatchUpSteps		 = 8;
+		constexpr Clock::duration MaxElapsed				 = TickDuration * MaxCatchUpSteps;
+	}// namespace
+
 	void EventHandler::loadEvents(EventList&& ev) {
-		_events = ev;
+		_events		 = std::move(ev);
+		_nextEvent = 0;
 	}
+
 	Event EventHandler::getNextEvent(Render& render) {
-		if (!_events.empty()) {
-			auto event = _events.front();
-			_events.erase(_events.begin());
-			// TODO process replay event
+		if (replaying()) {
+			if (!std::exchange(_pacing, true)) { render.setReplayPacer(&_pacer); }
+			const auto& event = _events[_nextEvent];
+			if (const auto* te = std::get_if<TimeElapsed>(&event); te != nullptr) {
+				if (auto live = paceReplayTick(*te, render); live) { return *live; }
+				_lastTick = Clock::now();
+			}
+			++_nextEvent;
 			return event;
 		}
+		if (std::exchange(_pacing, false)) { render.setReplayPacer(nullptr); }
 		if (auto mbEvent = render.getEvent(); mbEvent) { return mbEvent.value(); }
+		if (auto deviceEvent = nextDeviceEvent(); deviceEvent) { return *deviceEvent; }
+		_devicesPolled				 = false;
 		const auto nextTick		 = Clock::now();
 		const auto timeElapsed = nextTick - _lastTick;
 		_lastTick							 = nextTick;
+		if (timeElapsed > MaxElapsed) {
+			spdlog::warn("Frame took {:.1f} ms, simulating {:.1f} ms of it",
+									 std::chrono::duration<double, std::milli>{ timeElapsed }.count(),
+									 std::chrono::duration<double, std::milli>{ MaxElapsed }.count());
+			return TimeElapsed{ MaxElapsed };
+		}
 		return TimeElapsed{ timeElapsed };
 	}
 
-	void EventHandler::replayProcessEvent(const Event& event) {
-		// TODO move this to render, and process on replay
-		/* std::visit(overloaded{ [](const TimeElapsed& te) { std::this_thread::sleep_for(te.elapsed); },
-													 [&](const Moved<Mouse>& me) {
-															sf::Mouse::setPosition({ me.source.x, me.source.y }, window);
-													 },
-													 [](const auto& unused) {} },
-							 event);*/
+	// Live window events only reach the UI during a replay, the game sees the recording alone. CloseWindow is the
+	// exception and is returned to end the session.
+	std::optional<Event> EventHandler::paceReplayTick(const TimeElapsed& te, Render& render) {
+		GAME_ALLOC_SCOPE(Replay);
+		while (render.isOpen()) {
+			while (auto live = render.getEvent()) {
+				if (std::holds_alternative<CloseWindow>(*live)) { return live; }
+				render.processEvent(*live);
+			}
+
+			if (_pacer.ready() && _pacer.deadline(te.elapsed) - Clock::now() < IdleFrameThreshold) {
+				_pacer.wait(te.elapsed);
+				return {};
+			}
+			idleFrame();
+		}
+		return {};
+	}
+
+	std::optional<Event> EventHandler::nextDeviceEvent() {
+		if (_nextDeviceEvent == _deviceEvents.size()) {
+			if (_devices == nullptr || std::exchange(_devicesPolled, true)) { return {}; }
+			GAME_ALLOC_SCOPE(Input);
+			_deviceEvents.clear();
+			_nextDeviceEvent = 0;
+			_devices->pollEvents(_deviceEvents);
+			if (_deviceEvents.empty()) { return {}; }
+		}
+		return _deviceEvents[_nextDeviceEvent++];
+	}
+
+	void EventHandler::idleFrame() {
+		const auto start = Clock::now();
+		if (_idleFrame) { _idleFrame(TimeElapsed{ start - _lastTick }); }
+		_lastTick = start;
+		std::this_thread::sleep_until(start + IdleFrameInterval);
 	}
 
 
-}// namespace game
\ No newline at end of file
+}// namespace game
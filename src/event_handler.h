@@ -1,19 +1,53 @@
 #pragma once
 #include "event.h"
+#include "replay_pacer.h"
 #include <SFML/Graphics/RenderWindow.hpp>
+#include <functional>
+#include <optional>
+#include <utility>
 
 namespace game {
 	class Render;
+	class DeviceManager;
 
 	struct EventHandler {
 	private:
-		EventList					_events;
-		Clock::time_point _lastTick = game::Clock::now();
-		void							replayProcessEvent(const Event& ev);
+		EventList																 _events;
+		std::size_t															 _nextEvent = 0;
+		bool																		 _pacing		= false;
+		Clock::time_point												 _lastTick	= game::Clock::now();
+		ReplayPacer															 _pacer;
+		std::function<void(const TimeElapsed&)> _idleFrame;
+		DeviceManager*													 _devices = nullptr;
+		EventList																 _deviceEvents;
+		std::size_t															 _nextDeviceEvent = 0;
+		bool																		 _devicesPolled		= false;
+
+		std::optional<Event> paceReplayTick(const TimeElapsed& te, Render& render);
+		std::optional<Event> nextDeviceEvent();
+		void								 idleFrame();
 
 	public:
 		void	loadEvents(EventList&& ev);
 		Event getNextEvent(Render& render);
+
+		[[nodiscard]] bool replaying() const {
+			return _nextEvent < _events.size();
+		}
+
+		[[nodiscard]] ReplayPacer& pacer() {
+			return _pacer;
+		}
+
+		// Devices are polled once per tick while live, their changes come as events after the window's. Replays ignore them.
+		void setDevices(DeviceManager* devices) {
+			_devices = devices;
+		}
+
+		// Draws a frame without advancing the game, used while a replay is paused or waits for a long tick
+		void setIdleFrame(std::function<void(const TimeElapsed&)> idleFrame) {
+			_idleFrame = std::move(idleFrame);
+		}
 	};
 
-}// namespace game
\ No newline at end of file
+}// namespace game
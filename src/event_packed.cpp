@@ -0,0 +1,41 @@
+#include "event_packed.h"
+
+namespace game {
+	PackedEventList::PackedEventList(const EventList& events) {
+		reserve(events.size());
+		for (const auto& ev : events) { push_back(ev); }
+	}
+
+	void PackedEventList::push_back(const PackedEvent& packed) {
+		_types.push_back(packed.type);
+		_flags.push_back(packed.flags);
+		_a.push_back(packed.a);
+		_b.push_back(packed.b);
+	}
+
+	void PackedEventList::reserve(std::size_t count) {
+		_types.reserve(count);
+		_flags.reserve(count);
+		_a.reserve(count);
+		_b.reserve(count);
+	}
+
+	void PackedEventList::clear() {
+		_types.clear();
+		_flags.clear();
+		_a.clear();
+		_b.clear();
+	}
+
+	std::size_t PackedEventList::memoryUsage() const {
+		return _types.capacity() * sizeof(std::uint8_t) + _flags.capacity() * sizeof(std::uint8_t)
+					 + _a.capacity() * sizeof(std::uint32_t) + _b.capacity() * sizeof(std::uint64_t);
+	}
+
+	EventList PackedEventList::toEventList() const {
+		EventList events;
+		events.reserve(size());
+		for (std::size_t index = 0; index < size(); ++index) { events.push_back(unpack((*this)[index])); }
+		return events;
+	}
+}// namespace game
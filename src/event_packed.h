@@ -0,0 +1,253 @@
+#pragma once
+#include "event.h"
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace game {
+
+	// Fixed size tagged event record. The tag is the index of the alternative in Event,
+	// the payload layout per alternative is defined by the pack/unpack pairs below.
+	struct PackedEvent {
+		std::uint8_t	type			= 0;
+		std::uint8_t	flags			= 0;
+		std::uint16_t reserved	= 0;
+		std::uint32_t a					= 0;
+		std::uint64_t b					= 0;
+	};
+	static_assert(sizeof(PackedEvent) == 16);
+	static_assert(std::variant_size_v<Event> <= 256);
+	static_assert(sizeof(Clock::rep) <= sizeof(std::uint64_t));
+
+	namespace packing {
+		constexpr std::uint64_t pair(const std::uint32_t low, const std::uint32_t high) {
+			return low | (static_cast<std::uint64_t>(high) << 32U);
+		}
+
+		constexpr std::uint32_t low(const std::uint64_t value) {
+			return static_cast<std::uint32_t>(value);
+		}
+
+		constexpr std::uint32_t high(const std::uint64_t value) {
+			return static_cast<std::uint32_t>(value >> 32U);
+		}
+
+		constexpr void pack(PackedEvent& /*packed*/, const std::monostate& /*unused*/) {}
+		constexpr void pack(PackedEvent& /*packed*/, const CloseWindow& /*unused*/) {}
+
+		constexpr void pack(PackedEvent& packed, const TimeElapsed& te) {
+			packed.b = std::bit_cast<std::uint64_t>(std::int64_t{ te.elapsed.count() });
+		}
+
+		constexpr void pack(PackedEvent& packed, const JoystickButton& button) {
+			packed.a = button.id;
+			packed.b = button.button;
+		}
+
+		constexpr void pack(PackedEvent& packed, const JoystickAxis& axis) {
+			packed.a = axis.id;
+			packed.b = pair(axis.axis, std::bit_cast<std::uint32_t>(axis.position));
+		}
+
+		constexpr void pack(PackedEvent& packed, const Mouse& mouse) {
+			packed.a = std::bit_cast<std::uint32_t>(mouse.x);
+			packed.b = std::bit_cast<std::uint32_t>(mouse.y);
+		}
+
+		constexpr void pack(PackedEvent& packed, const MouseButton& button) {
+			packed.a = std::bit_cast<std::uint32_t>(button.button);
+			packed.b = pair(std::bit_cast<std::uint32_t>(button.mouse.x), std::bit_cast<std::uint32_t>(button.mouse.y));
+		}
+
+		constexpr void pack(PackedEvent& packed, const Checkpoint& checkpoint) {
+			packed.a = checkpoint.tick;
+			packed.b = checkpoint.hash;
+		}
+
+		constexpr void pack(PackedEvent& packed, const JoystickDevice& device) {
+			packed.a = device.id;
+			packed.b = device.buttonCount;
+		}
+
+		constexpr void pack(PackedEvent& packed, const Key& key) {
+			packed.flags = static_cast<std::uint8_t>(static_cast<unsigned int>(key.alt) | (static_cast<unsigned int>(key.control) << 1U)
+																							 | (static_cast<unsigned int>(key.system) << 2U)
+																							 | (static_cast<unsigned int>(key.shift) << 3U));
+			packed.a		 = std::bit_cast<std::uint32_t>(static_cast<std::int32_t>(key.key));
+		}
+
+		template<typename Source>
+		constexpr void pack(PackedEvent& packed, const Pressed<Source>& ev) {
+			pack(packed, ev.source);
+		}
+
+		template<typename Source>
+		constexpr void pack(PackedEvent& packed, const Released<Source>& ev) {
+			pack(packed, ev.source);
+		}
+
+		template<typename Source>
+		constexpr void pack(PackedEvent& packed, const Moved<Source>& ev) {
+			pack(packed, ev.source);
+		}
+
+		template<typename Source>
+		constexpr void pack(PackedEvent& packed, const Connected<Source>& ev) {
+			pack(packed, ev.source);
+		}
+
+		template<typename Source>
+		constexpr void pack(PackedEvent& packed, const Disconnected<Source>& ev) {
+			pack(packed, ev.source);
+		}
+
+		template<typename T>
+		struct Tag {};
+
+		constexpr std::monostate unpack(const PackedEvent& /*packed*/, Tag<std::monostate> /*unused*/) {
+			return {};
+		}
+
+		constexpr CloseWindow unpack(const PackedEvent& /*packed*/, Tag<CloseWindow> /*unused*/) {
+			return {};
+		}
+
+		constexpr TimeElapsed unpack(const PackedEvent& packed, Tag<TimeElapsed> /*unused*/) {
+			return TimeElapsed{ Clock::duration{ std::bit_cast<std::int64_t>(packed.b) } };
+		}
+
+		constexpr JoystickButton unpack(const PackedEvent& packed, Tag<JoystickButton> /*unused*/) {
+			return JoystickButton{ packed.a, low(packed.b) };
+		}
+
+		constexpr JoystickAxis unpack(const PackedEvent& packed, Tag<JoystickAxis> /*unused*/) {
+			return JoystickAxis{ packed.a, low(packed.b), std::bit_cast<float>(high(packed.b)) };
+		}
+
+		constexpr Mouse unpack(const PackedEvent& packed, Tag<Mouse> /*unused*/) {
+			return Mouse{ std::bit_cast<int>(packed.a), std::bit_cast<int>(low(packed.b)) };
+		}
+
+		constexpr MouseButton unpack(const PackedEvent& packed, Tag<MouseButton> /*unused*/) {
+			return MouseButton{ std::bit_cast<int>(packed.a),
+													Mouse{ std::bit_cast<int>(low(packed.b)), std::bit_cast<int>(high(packed.b)) } };
+		}
+
+		constexpr Checkpoint unpack(const PackedEvent& packed, Tag<Checkpoint> /*unused*/) {
+			return Checkpoint{ packed.a, packed.b };
+		}
+
+		constexpr JoystickDevice unpack(const PackedEvent& packed, Tag<JoystickDevice> /*unused*/) {
+			return JoystickDevice{ packed.a, low(packed.b) };
+		}
+
+		constexpr Key unpack(const PackedEvent& packed, Tag<Key> /*unused*/) {
+			return Key{ (packed.flags & 1U) != 0,
+									(packed.flags & 2U) != 0,
+									(packed.flags & 4U) != 0,
+									(packed.flags & 8U) != 0,
+									static_cast<sf::Keyboard::Key>(std::bit_cast<std::int32_t>(packed.a)) };
+		}
+
+		template<typename Source>
+		constexpr Pressed<Source> unpack(const PackedEvent& packed, Tag<Pressed<Source>> /*unused*/) {
+			return Pressed<Source>{ unpack(packed, Tag<Source>{}) };
+		}
+
+		template<typename Source>
+		constexpr Released<Source> unpack(const PackedEvent& packed, Tag<Released<Source>> /*unused*/) {
+			return Released<Source>{ unpack(packed, Tag<Source>{}) };
+		}
+
+		template<typename Source>
+		constexpr Moved<Source> unpack(const PackedEvent& packed, Tag<Moved<Source>> /*unused*/) {
+			return Moved<Source>{ unpack(packed, Tag<Source>{}) };
+		}
+
+		template<typename Source>
+		constexpr Connected<Source> unpack(const PackedEvent& packed, Tag<Connected<Source>> /*unused*/) {
+			return Connected<Source>{ unpack(packed, Tag<Source>{}) };
+		}
+
+		template<typename Source>
+		constexpr Disconnected<Source> unpack(const PackedEvent& packed, Tag<Disconnected<Source>> /*unused*/) {
+			return Disconnected<Source>{ unpack(packed, Tag<Source>{}) };
+		}
+	}// namespace packing
+
+	constexpr PackedEvent pack(const Event& ev) {
+		PackedEvent packed;
+		packed.type = static_cast<std::uint8_t>(ev.index());
+		std::visit([&](const auto& alternative) { packing::pack(packed, alternative); }, ev);
+		return packed;
+	}
+
+	template<typename EventType>
+	constexpr EventType unpackAs(const PackedEvent& packed) {
+		return packing::unpack(packed, packing::Tag<EventType>{});
+	}
+
+	// Calls visitor with the concrete alternative stored in packed, without building an Event on the way
+	template<typename Visitor>
+	decltype(auto) visit(Visitor&& visitor, const PackedEvent& packed) {
+		using VisitorRef = std::remove_reference_t<Visitor>&;
+		using Result		 = std::invoke_result_t<VisitorRef, const std::variant_alternative_t<0, Event>&>;
+
+		return [&]<std::size_t... Index>(std::index_sequence<Index...>) -> Result {
+			static constexpr std::array<Result (*)(VisitorRef, const PackedEvent&), sizeof...(Index)> dispatch{
+				[](VisitorRef v, const PackedEvent& p) -> Result {
+					return v(unpackAs<std::variant_alternative_t<Index, Event>>(p));
+				}...
+			};
+			return dispatch.at(packed.type)(visitor, packed);
+		}(std::make_index_sequence<std::variant_size_v<Event>>{});
+	}
+
+	inline Event unpack(const PackedEvent& packed) {
+		return visit([](const auto& alternative) -> Event { return alternative; }, packed);
+	}
+
+	// Structure of arrays list of packed events, every column is contiguous
+	class PackedEventList {
+	private:
+		std::vector<std::uint8_t>	 _types;
+		std::vector<std::uint8_t>	 _flags;
+		std::vector<std::uint32_t> _a;
+		std::vector<std::uint64_t> _b;
+
+	public:
+		PackedEventList() = default;
+		explicit PackedEventList(const EventList& events);
+
+		void push_back(const PackedEvent& packed);
+
+		void push_back(const Event& ev) {
+			push_back(pack(ev));
+		}
+
+		[[nodiscard]] PackedEvent operator[](std::size_t index) const {
+			return PackedEvent{ _types[index], _flags[index], 0, _a[index], _b[index] };
+		}
+
+		[[nodiscard]] std::size_t size() const {
+			return _types.size();
+		}
+
+		[[nodiscard]] bool empty() const {
+			return _types.empty();
+		}
+
+		void reserve(std::size_t count);
+		void clear();
+
+		// Heap bytes held by the columns
+		[[nodiscard]] std::size_t memoryUsage() const;
+
+		[[nodiscard]] EventList toEventList() const;
+	};
+
+}// namespace game
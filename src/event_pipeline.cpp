@@ -0,0 +1,141 @@
+#include "event_pipeline.h"
+#include "event_handler.h"
+#include "event_recorder.h"
+#include "game_state.h"
+#include "render.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace game {
+	namespace {
+		bool endsBatch(const Event& ev) {
+			return std::holds_alternative<TimeElapsed>(ev) || std::holds_alternative<CloseWindow>(ev);
+		}
+
+		// Single consumer worker fed through an unbounded queue
+		class Worker {
+		private:
+			std::mutex															 _mutex;
+			std::condition_variable									 _ready;
+			std::deque<EventList>										 _queue;
+			bool																		 _closed = false;
+			std::function<void(const EventList&)> _consumer;
+			std::jthread														 _thread;
+
+			std::optional<EventList> pop() {
+				std::unique_lock lock{ _mutex };
+				_ready.wait(lock, [&] { return _closed || !_queue.empty(); });
+				if (_queue.empty()) { return {}; }
+				auto batch = std::move(_queue.front());
+				_queue.pop_front();
+				return batch;
+			}
+
+		public:
+			explicit Worker(std::function<void(const EventList&)> consumer)
+				: _consumer{ std::move(consumer) }
+				, _thread{ [this] {
+					while (const auto batch = pop()) { _consumer(*batch); }
+				} } {}
+
+			Worker(const Worker&) = delete;
+			Worker& operator=(const Worker&) = delete;
+
+			// Whatever is queued is still consumed before the thread is joined
+			~Worker() {
+				{
+					std::scoped_lock lock{ _mutex };
+					_closed = true;
+				}
+				_ready.notify_one();
+			}
+
+			void push(const EventList& batch) {
+				{
+					std::scoped_lock lock{ _mutex };
+					_queue.push_back(batch);
+				}
+				_ready.notify_one();
+			}
+		};
+	}// namespace
+
+	EventBatches batches(EventHandler& eventHandler, Render& render) {
+		EventList batch;
+		while (render.isOpen()) {
+			batch.clear();
+			do {
+				batch.push_back(eventHandler.getNextEvent(render));
+			} while (!endsBatch(batch.back()));
+			co_yield batch;
+		}
+	}
+
+	EventBatches batches(EventList events) {
+		EventList batch;
+		for (auto& ev : events) {
+			batch.push_back(std::move(ev));
+			if (endsBatch(batch.back())) {
+				co_yield batch;
+				batch.clear();
+			}
+		}
+		if (!batch.empty()) { co_yield batch; }
+	}
+
+	namespace stages {
+		EventBatches coalesce(EventBatches upstream) {
+			for (auto& batch : upstream) {
+				std::size_t kept = 0;
+				for (std::size_t index = 0; index < batch.size(); ++index) {
+					const bool superseded = kept > 0 && std::holds_alternative<Moved<Mouse>>(batch[kept - 1])
+																	&& std::holds_alternative<Moved<Mouse>>(batch[index]);
+					const auto target			= superseded ? kept - 1 : kept++;
+					if (target != index) { batch[target] = std::move(batch[index]); }
+				}
+				batch.resize(kept);
+				co_yield batch;
+			}
+		}
+
+		EventBatches simulate(EventBatches upstream, GameState& gs, std::function<void(const Event&)> afterEvent) {
+			for (auto& batch : upstream) {
+				for (const auto& ev : batch) {
+					gs.processEvent(ev);
+					if (afterEvent) { afterEvent(ev); }
+				}
+				co_yield batch;
+			}
+		}
+
+		EventBatches record(EventBatches upstream, EventRecorder& recorder, GameState& gs) {
+			for (auto& batch : upstream) {
+				for (const auto& ev : batch) { recorder.processEvent(ev); }
+				if (!batch.empty() && std::holds_alternative<TimeElapsed>(batch.back()) && recorder.checkpointDue()) {
+					recorder.checkpoint(gs.hash());
+				}
+				co_yield batch;
+			}
+		}
+
+		EventBatches present(EventBatches upstream, Render& render, const GameState& gs) {
+			for (auto& batch : upstream) {
+				for (const auto& ev : batch) { render.processEvent(ev); }
+				render.processRender(gs);
+				co_yield batch;
+			}
+		}
+
+		EventBatches offload(EventBatches upstream, std::function<void(const EventList&)> consumer) {
+			Worker worker{ std::move(consumer) };
+			for (auto& batch : upstream) {
+				worker.push(batch);
+				co_yield batch;
+			}
+		}
+	}// namespace stages
+
+}// namespace game
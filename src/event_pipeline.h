@@ -0,0 +1,87 @@
+#pragma once
+#include "event.h"
+#include "generator.h"
+#include <concepts>
+#include <functional>
+#include <utility>
+
+namespace game {
+	struct EventHandler;
+	class EventRecorder;
+	class Render;
+	struct GameState;
+
+	// Events of one tick: everything up to and including the TimeElapsed that ends it.
+	// A CloseWindow also ends a batch, since nothing after it will be rendered anymore.
+	using EventBatches = Generator<EventList>;
+
+	// A stage takes the upstream batches and yields its own, usually the same batch objects modified in place
+	template<typename Stage>
+	concept PipelineStage = std::invocable<Stage, EventBatches> && std::same_as<std::invoke_result_t<Stage, EventBatches>, EventBatches>;
+
+	template<PipelineStage Stage>
+	EventBatches operator|(EventBatches&& upstream, Stage&& stage) {
+		return std::invoke(std::forward<Stage>(stage), std::move(upstream));
+	}
+
+	// Sources
+	EventBatches batches(EventHandler& eventHandler, Render& render);
+	EventBatches batches(EventList events);
+
+	namespace stages {
+		template<typename Predicate>
+		EventBatches filter(EventBatches upstream, Predicate predicate) {
+			for (auto& batch : upstream) {
+				std::erase_if(batch, [&](const Event& ev) { return !predicate(ev); });
+				co_yield batch;
+			}
+		}
+
+		EventBatches coalesce(EventBatches upstream);
+		EventBatches simulate(EventBatches upstream, GameState& gs, std::function<void(const Event&)> afterEvent);
+		EventBatches record(EventBatches upstream, EventRecorder& recorder, GameState& gs);
+		EventBatches present(EventBatches upstream, Render& render, const GameState& gs);
+		EventBatches offload(EventBatches upstream, std::function<void(const EventList&)> consumer);
+	}// namespace stages
+
+	// Stage factories for composing with operator|. Stages keep references to the objects they are given,
+	// those have to outlive the pipeline.
+
+	// Drops every event the predicate rejects
+	template<typename Predicate>
+	auto filter(Predicate predicate) {
+		return [predicate](EventBatches upstream) { return stages::filter(std::move(upstream), predicate); };
+	}
+
+	// Collapses runs of mouse moves into the last one. Joystick axes are left alone, every intermediate position
+	// can cross an action threshold.
+	inline auto coalesce() {
+		return [](EventBatches upstream) { return stages::coalesce(std::move(upstream)); };
+	}
+
+	// Feeds every event to the game state, afterEvent sees the state right after each event
+	inline auto simulate(GameState& gs, std::function<void(const Event&)> afterEvent = {}) {
+		return [&gs, afterEvent = std::move(afterEvent)](EventBatches upstream) {
+			return stages::simulate(std::move(upstream), gs, afterEvent);
+		};
+	}
+
+	// Records the batch and checkpoints the state hash, so it has to come after simulate
+	inline auto record(EventRecorder& recorder, GameState& gs) {
+		return [&recorder, &gs](EventBatches upstream) { return stages::record(std::move(upstream), recorder, gs); };
+	}
+
+	// Hands the events to the UI and renders one frame per batch
+	inline auto present(Render& render, const GameState& gs) {
+		return [&render, &gs](EventBatches upstream) { return stages::present(std::move(upstream), render, gs); };
+	}
+
+	// Runs consumer on a worker thread with a copy of every batch while the batch itself continues downstream.
+	// Batches reach the consumer in order, the worker is drained and joined when the pipeline is destroyed.
+	inline auto offload(std::function<void(const EventList&)> consumer) {
+		return [consumer = std::move(consumer)](EventBatches upstream) {
+			return stages::offload(std::move(upstream), consumer);
+		};
+	}
+
+}// namespace game
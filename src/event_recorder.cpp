@@ -1,4 +1,5 @@
 #include "event_recorder.h"
+#include "alloc_tracker.h"
 #include "event_serialize.h"
 #include "utility.h"
 #include <fstream>
@@ -6,15 +7,26 @@
 
 namespace game {
 	void EventRecorder::processEvent(const Event& ev) {
+		GAME_ALLOC_SCOPE(Recorder);
 		std::visit(
 			game::overloaded{ [](game::TimeElapsed& prev, const game::TimeElapsed& next) { prev.elapsed += next.elapsed; },
 												[&](const auto& /*prev*/, const std::monostate& /*unused*/) {},
+												// checkpoints of a replayed recording, this recorder writes its own
+												[&](const auto& /*prev*/, const game::Checkpoint& /*unused*/) {},
 												[&](const auto& /*prev*/, const auto& next) { _events.push_back(next); } },
 			_events.back(),
 			ev);
 
+		if (std::holds_alternative<game::TimeElapsed>(ev)) { ++_ticks; }
 		++_eventsProcessed;
 	}
+
+	void EventRecorder::checkpoint(const std::uint64_t hash) {
+		GAME_ALLOC_SCOPE(Recorder);
+		if (!checkpointDue()) { return; }
+		_events.push_back(game::Checkpoint{ _ticks, hash });
+		_lastCheckpoint = _ticks;
+	}
 	void EventRecorder::printInfo() const {
 
 		spdlog::info("Total events processed: {}, total recorded {}", _eventsProcessed, _events.size());
@@ -1,15 +1,35 @@
 #pragma once
 #include "event.h"
+#include <cstdint>
 
 namespace game {
 	class EventRecorder {
 	private:
 		EventList _events{ game::TimeElapsed{} };
 		uint32_t	_eventsProcessed{ 0 };
+		uint32_t	_ticks{ 0 };
+		uint32_t	_checkpointInterval;
+		uint32_t	_lastCheckpoint{ 0 };
 
 	public:
+		explicit EventRecorder(uint32_t checkpointInterval = 60)
+			: _checkpointInterval{ checkpointInterval } {}
+
 		void processEvent(const Event& ev);
 
+		// Records the state hash after the TimeElapsed that was just processed, once every checkpointInterval ticks.
+		// The checkpoint also stops the next TimeElapsed from being merged into the one it belongs to.
+		void checkpoint(std::uint64_t hash);
+
+		// Whether checkpoint() would record, so the hash is only computed when it is needed
+		[[nodiscard]] bool checkpointDue() const {
+			return _ticks >= _lastCheckpoint + _checkpointInterval;
+		}
+
+		[[nodiscard]] const EventList& events() const {
+			return _events;
+		}
+
 		void printInfo() const;
 
 		void serialize(std::string_view fileName) const;
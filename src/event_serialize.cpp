@@ -1,4 +1,5 @@
 #include "event_serialize.h"
+#include "alloc_tracker.h"
 #include "utility.h"
 #include <nlohmann/json.hpp>
 #include <string>
@@ -146,12 +147,14 @@ namespace game {
 	}
 
 	std::istream& operator>>(std::istream& is, EventList& events) {
+		GAME_ALLOC_SCOPE(Serialize);
 		const auto j = nlohmann::json::parse(is);
 		events			 = j.get<EventList>();
 		return is;
 	}
 
 	std::ostream& operator<<(std::ostream& os, const game::EventList& events) {
+		GAME_ALLOC_SCOPE(Serialize);
 		nlohmann::json serialized(events);
 		os << serialized;
 		return os;
@@ -1,7 +1,11 @@
 #pragma once
 #include "event.h"
 #include <iostream>
+#include <nlohmann/json_fwd.hpp>
 namespace game {
 	std::istream& operator>>(std::istream& is, EventList& events);
 	std::ostream& operator<<(std::ostream& os, const game::EventList& events);
-}// namespace game
\ No newline at end of file
+
+	void to_json(nlohmann::json& j, const game::Event& event);
+	void from_json(const nlohmann::json& j, game::Event& event);
+}// namespace game
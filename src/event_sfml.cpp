@@ -57,6 +57,14 @@ namespace game {
 		return sf::Event{ .type = sf::Event::MouseButtonPressed, .mouseButton = toSFMLEventInternal(value.source) };
 	}
 
+	static sf::Event toSFMLEventInternal(const Connected<JoystickDevice>& value) {
+		return sf::Event{ .type = sf::Event::JoystickConnected, .joystickConnect = { .joystickId = value.source.id } };
+	}
+
+	static sf::Event toSFMLEventInternal(const Disconnected<JoystickDevice>& value) {
+		return sf::Event{ .type = sf::Event::JoystickDisconnected, .joystickConnect = { .joystickId = value.source.id } };
+	}
+
 	static sf::Event toSFMLEventInternal(const CloseWindow& /*unused*/) {
 		return sf::Event{ .type = sf::Event::Closed, .size = {} };
 	}
@@ -69,6 +77,9 @@ namespace game {
 									},
 									[&](const std::monostate & /*unused*/) -> std::optional<sf::Event> {// dummy event for NOP
 										return {};
+									},
+									[&](const Checkpoint & /*unused*/) -> std::optional<sf::Event> {// replay bookkeeping, not an input
+										return {};
 									}
 
 			},
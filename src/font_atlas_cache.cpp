@@ -0,0 +1,249 @@
+#include "font_atlas_cache.h"
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fmt/format.h>
+#include <fstream>
+#include <imgui.h>
+#include <iterator>
+#include <span>
+#include <spdlog/spdlog.h>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace game {
+	static constexpr float												 BaseFontSize = 13.f;
+	static constexpr std::array<char, 8>					 CacheMagic{ 'G', 'A', 'M', 'E', 'F', 'N', 'T', '1' };
+	static constexpr std::size_t									 PixelAlignment = 16;
+	static constexpr std::string_view							 DefaultFontName{ "ProggyClean.ttf" };
+
+	struct CacheHeader {
+		std::array<char, 8> magic;
+		std::uint64_t				key;
+		std::uint32_t				glyphSize;
+		std::uint32_t				glyphCount;
+		std::uint32_t				uvLinesSize;
+		std::uint32_t				fallbackChar;
+		std::int32_t				texWidth;
+		std::int32_t				texHeight;
+		float								whiteU;
+		float								whiteV;
+		float								fontSize;
+		float								ascent;
+		float								descent;
+		std::uint64_t				glyphOffset;
+		std::uint64_t				uvLinesOffset;
+		std::uint64_t				pixelOffset;
+	};
+
+	class Fnv1a {
+	private:
+		std::uint64_t _value = 14695981039346656037ULL;
+
+	public:
+		void add(std::span<const std::byte> bytes) {
+			for (const auto byte : bytes) {
+				_value ^= static_cast<std::uint8_t>(byte);
+				_value *= 1099511628211ULL;
+			}
+		}
+
+		template<typename T>
+		void addValue(const T& value) {
+			add(std::as_bytes(std::span{ &value, 1 }));
+		}
+
+		[[nodiscard]] std::uint64_t value() const {
+			return _value;
+		}
+	};
+
+	// Fields that only exist in some ImGui versions
+	template<typename Atlas>
+	static std::span<std::byte> texUvLines(Atlas& atlas) {
+		if constexpr (requires { atlas.TexUvLines; }) {
+			return std::as_writable_bytes(std::span{ atlas.TexUvLines });
+		} else {
+			return {};
+		}
+	}
+
+	template<typename Atlas>
+	static void markTextureReady(Atlas& atlas) {
+		if constexpr (requires { atlas.TexReady; }) { atlas.TexReady = true; }
+	}
+
+	static std::vector<std::uint8_t> readFile(const std::filesystem::path& path) {
+		std::ifstream ifs{ path, std::ios::binary };
+		return { std::istreambuf_iterator<char>{ ifs }, std::istreambuf_iterator<char>{} };
+	}
+
+	static std::uint64_t cacheKey(const std::vector<std::uint8_t>& fontData, float sizePixels) {
+		Fnv1a hash;
+		hash.add(std::as_bytes(std::span{ CacheMagic }));
+		hash.addValue(IMGUI_VERSION_NUM);
+		hash.addValue(sizeof(ImFontGlyph));
+		hash.addValue(sizePixels);
+		if (fontData.empty()) {
+			hash.add(std::as_bytes(std::span{ DefaultFontName }));
+		} else {
+			hash.add(std::as_bytes(std::span{ fontData }));
+		}
+		return hash.value();
+	}
+
+	static void rasterize(ImFontAtlas& atlas, const std::vector<std::uint8_t>& fontData, float sizePixels) {
+		ImFontConfig config;
+		config.SizePixels = sizePixels;
+		if (fontData.empty()) {
+			atlas.AddFontDefault(&config);
+		} else {
+			// the atlas takes ownership of the font data
+			auto* data = IM_ALLOC(fontData.size());
+			std::memcpy(data, fontData.data(), fontData.size());
+			atlas.AddFontFromMemoryTTF(data, static_cast<int>(fontData.size()), sizePixels, &config);
+		}
+
+		unsigned char* pixels = nullptr;
+		int						 width	= 0;
+		int						 height = 0;
+		atlas.GetTexDataAsRGBA32(&pixels, &width, &height);
+	}
+
+	static std::uint64_t align(std::uint64_t offset) {
+		return (offset + PixelAlignment - 1) / PixelAlignment * PixelAlignment;
+	}
+
+	static void store(ImFontAtlas& atlas, std::uint64_t key, const std::filesystem::path& path) {
+		const auto& font		= *atlas.Fonts[0];
+		const auto	uvLines = texUvLines(atlas);
+
+		CacheHeader header{};
+		header.magic				 = CacheMagic;
+		header.key					 = key;
+		header.glyphSize		 = sizeof(ImFontGlyph);
+		header.glyphCount		 = static_cast<std::uint32_t>(font.Glyphs.Size);
+		header.uvLinesSize	 = static_cast<std::uint32_t>(uvLines.size());
+		header.fallbackChar	 = font.FallbackChar;
+		header.texWidth			 = atlas.TexWidth;
+		header.texHeight		 = atlas.TexHeight;
+		header.whiteU				 = atlas.TexUvWhitePixel.x;
+		header.whiteV				 = atlas.TexUvWhitePixel.y;
+		header.fontSize			 = font.FontSize;
+		header.ascent				 = font.Ascent;
+		header.descent			 = font.Descent;
+		header.glyphOffset	 = sizeof(CacheHeader);
+		header.uvLinesOffset = header.glyphOffset + header.glyphCount * sizeof(ImFontGlyph);
+		header.pixelOffset	 = align(header.uvLinesOffset + header.uvLinesSize);
+
+		const auto glyphs		 = std::as_bytes(std::span{ font.Glyphs.Data, static_cast<std::size_t>(font.Glyphs.Size) });
+		const auto pixelSize = static_cast<std::size_t>(atlas.TexWidth) * static_cast<std::size_t>(atlas.TexHeight) * 4;
+		const auto pixels		 = std::as_bytes(std::span{ atlas.TexPixelsRGBA32, pixelSize / 4 });
+		const std::vector<char> padding(header.pixelOffset - header.uvLinesOffset - header.uvLinesSize);
+
+		// write next to the target and rename, so a crash never leaves a truncated atlas behind
+		auto tmpPath = path;
+		tmpPath += ".tmp";
+		{
+			std::ofstream ofs{ tmpPath, std::ios::binary | std::ios::trunc };
+			const auto		write = [&](std::span<const std::byte> bytes) {
+				ofs.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+			};
+			write(std::as_bytes(std::span{ &header, 1 }));
+			write(glyphs);
+			write(uvLines);
+			write(std::as_bytes(std::span{ padding }));
+			write(pixels);
+			if (!ofs) {
+				spdlog::warn("Unable to write font atlas cache {}", tmpPath.string());
+				return;
+			}
+		}
+		std::error_code error;
+		std::filesystem::rename(tmpPath, path, error);
+		if (error) { spdlog::warn("Unable to store font atlas cache {}: {}", path.string(), error.message()); }
+	}
+
+	static bool restore(ImFontAtlas& atlas, const MappedFile& mapped, std::uint64_t key) {
+		const auto bytes = mapped.bytes();
+		if (bytes.size() < sizeof(CacheHeader)) { return false; }
+
+		CacheHeader header{};
+		std::memcpy(&header, bytes.data(), sizeof(CacheHeader));
+		const auto uvLines	 = texUvLines(atlas);
+		const auto pixelSize = static_cast<std::uint64_t>(header.texWidth) * static_cast<std::uint64_t>(header.texHeight) * 4;
+		if (header.magic != CacheMagic || header.key != key || header.glyphSize != sizeof(ImFontGlyph)
+				|| header.uvLinesSize != uvLines.size() || header.texWidth <= 0 || header.texHeight <= 0
+				|| header.pixelOffset % PixelAlignment != 0 || bytes.size() < header.pixelOffset + pixelSize
+				|| header.uvLinesOffset + header.uvLinesSize > header.pixelOffset
+				|| header.glyphOffset + header.glyphCount * sizeof(ImFontGlyph) > header.uvLinesOffset) {
+			return false;
+		}
+
+		ImFontConfig config;
+		config.SizePixels						= header.fontSize;
+		config.FontDataOwnedByAtlas = false;
+		atlas.ConfigData.push_back(config);
+
+		auto* font = IM_NEW(ImFont);
+		atlas.Fonts.push_back(font);
+		atlas.ConfigData.back().DstFont = font;
+		font->ContainerAtlas						= &atlas;
+		font->ConfigData								= &atlas.ConfigData.back();
+		font->ConfigDataCount						= 1;
+		font->FontSize									= header.fontSize;
+		font->Ascent										= header.ascent;
+		font->Descent										= header.descent;
+		font->FallbackChar							= static_cast<ImWchar>(header.fallbackChar);
+		font->Glyphs.resize(static_cast<int>(header.glyphCount));
+		std::memcpy(font->Glyphs.Data, bytes.subspan(header.glyphOffset).data(), header.glyphCount * sizeof(ImFontGlyph));
+		font->BuildLookupTable();
+
+		std::memcpy(uvLines.data(), bytes.subspan(header.uvLinesOffset).data(), uvLines.size());
+		atlas.TexWidth				= header.texWidth;
+		atlas.TexHeight				= header.texHeight;
+		atlas.TexUvScale			= ImVec2(1.f / static_cast<float>(header.texWidth), 1.f / static_cast<float>(header.texHeight));
+		atlas.TexUvWhitePixel = ImVec2(header.whiteU, header.whiteV);
+		// ImGui only reads the pixels to upload them, see release() for the ownership hand back
+		atlas.TexPixelsRGBA32 =
+			reinterpret_cast<unsigned int*>(const_cast<std::uint8_t*>(bytes.subspan(header.pixelOffset).data()));
+		markTextureReady(atlas);
+		return true;
+	}
+
+	FontAtlasCache::FontAtlasCache(std::filesystem::path directory)
+		: _directory{ std::move(directory) } {
+		std::error_code error;
+		std::filesystem::create_directories(_directory, error);
+		if (error) { spdlog::warn("Font atlas cache {} is not usable: {}", _directory.string(), error.message()); }
+	}
+
+	bool FontAtlasCache::load(ImFontAtlas& atlas, float scale, const std::filesystem::path& fontFile) {
+		const float							 sizePixels = std::round(BaseFontSize * scale);
+		std::vector<std::uint8_t> fontData;
+		if (!fontFile.empty()) {
+			fontData = readFile(fontFile);
+			if (fontData.empty()) { spdlog::warn("Unable to read font {}, using the default font", fontFile.string()); }
+		}
+
+		const auto key	= cacheKey(fontData, sizePixels);
+		const auto path = _directory / fmt::format("{:016x}.atlas", key);
+		if (auto mapped = MappedFile::open(path); mapped && restore(atlas, *mapped, key)) {
+			_mapped = std::move(mapped);
+			return true;
+		}
+
+		rasterize(atlas, fontData, sizePixels);
+		store(atlas, key, path);
+		return false;
+	}
+
+	void FontAtlasCache::release(ImFontAtlas& atlas) {
+		if (!_mapped) { return; }
+		const auto bytes	= _mapped->bytes();
+		const auto* pixels = reinterpret_cast<const std::uint8_t*>(atlas.TexPixelsRGBA32);
+		if (pixels >= bytes.data() && pixels < bytes.data() + bytes.size()) { atlas.TexPixelsRGBA32 = nullptr; }
+		_mapped.reset();
+	}
+}// namespace game
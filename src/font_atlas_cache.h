@@ -0,0 +1,29 @@
+#pragma once
+#include "mapped_file.h"
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+
+struct ImFontAtlas;
+
+namespace game {
+
+	// Rasterizes the UI font once per (font, scale) and keeps the atlas pixels and glyph tables on disk.
+	// A cached atlas is memory mapped and handed to ImGui without rasterizing again.
+	class FontAtlasCache {
+	private:
+		std::filesystem::path		 _directory;
+		std::optional<MappedFile> _mapped;
+
+	public:
+		explicit FontAtlasCache(std::filesystem::path directory);
+
+		// Fills an empty atlas with the font at the given UI scale. An empty fontFile selects ImGui's default font.
+		// Returns true when the atlas came from the cache.
+		bool load(ImFontAtlas& atlas, float scale, const std::filesystem::path& fontFile = {});
+
+		// Detaches mapped pixels from the atlas, must run before ImGui destroys it
+		void release(ImFontAtlas& atlas);
+	};
+
+}// namespace game
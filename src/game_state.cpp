@@ -1,13 +1,255 @@
 #include "game_state.h"
+#include "alloc_tracker.h"
+#include "components.h"
 #include "utility.h"
+#include <algorithm>
+#include <span>
 namespace game {
 
+	namespace {
+		std::uint64_t toValue(const std::optional<Entity>& entity) {
+			return entity ? (static_cast<std::uint64_t>(entity->generation) << 32U | entity->index) + 1 : 0;
+		}
+
+		Bounds boundsOf(const Position& position, const Shape& shape) {
+			return Bounds{ position.x - shape.halfWidth,
+										 position.y - shape.halfHeight,
+										 position.x + shape.halfWidth,
+										 position.y + shape.halfHeight };
+		}
+
+		template<typename T>
+		std::uint64_t vectorHash(const StateHash::Domain domain, const std::uint32_t index, const T& value) {
+			return StateHash::contribution(StateHash::slot(domain, index, 0), StateHash::toValue(value.x))
+						 ^ StateHash::contribution(StateHash::slot(domain, index, 1), StateHash::toValue(value.y));
+		}
+
+		template<Component T>
+		std::uint64_t vectorHash(World& world, const StateHash::Domain domain) {
+			std::uint64_t result = 0;
+			for (const auto& chunk : world.chunks(componentMask<T>())) {
+				const auto entities = chunk.entities();
+				const auto values		= chunk.template column<T>();
+				for (std::size_t row = 0; row < chunk.size(); ++row) {
+					result ^= vectorHash(domain, entities[row].index, values[row]);
+				}
+			}
+			return result;
+		}
+
+		std::uint64_t entityHash(const Entity entity, const Position* position, const Velocity* velocity) {
+			auto result = StateHash::contribution(StateHash::slot(StateHash::Domain::Entity, entity.index),
+																						std::uint64_t{ entity.generation } + 1);
+			if (position != nullptr) { result ^= vectorHash(StateHash::Domain::Position, entity.index, *position); }
+			if (velocity != nullptr) { result ^= vectorHash(StateHash::Domain::Velocity, entity.index, *velocity); }
+			return result;
+		}
+
+		void setEntityHash(GameState& gs, const std::uint32_t index, const std::uint64_t hash) {
+			if (index >= gs._entityHashes.size()) { gs._entityHashes.resize(index + 1, 0); }
+			gs._worldHash.toggle(gs._entityHashes[index] ^ hash);
+			gs._entityHashes[index] = hash;
+		}
+
+		void rehashChunk(GameState& gs, const ChunkView& chunk) {
+			const auto entities		= chunk.entities();
+			const auto positions	= chunk.has<Position>() ? chunk.column<Position>() : std::span<Position>{};
+			const auto velocities = chunk.has<Velocity>() ? chunk.column<Velocity>() : std::span<Velocity>{};
+			for (std::size_t row = 0; row < chunk.size(); ++row) {
+				setEntityHash(gs,
+											entities[row].index,
+											entityHash(entities[row],
+																 positions.empty() ? nullptr : &positions[row],
+																 velocities.empty() ? nullptr : &velocities[row]));
+			}
+		}
+
+		// Must run before the spatial index consumes the list. Destroyed entities are listed before anything that
+		// reuses their index, so the last entry for an index decides its hash.
+		void hashStructuralChanges(GameState& gs) {
+			if (!gs._worldHash.enabled()) { return; }
+			for (const auto entity : gs._world.structuralChanges()) {
+				const auto hash = gs._world.alive(entity)
+														? entityHash(entity, gs._world.get<Position>(entity), gs._world.get<Velocity>(entity))
+														: 0;
+				setEntityHash(gs, entity.index, hash);
+			}
+		}
+	}// namespace
+
+	static auto eventHandlers(GameState& gs) {
+		return game::overloaded{ [&](const game::JoystickEvent auto& jsEvent) {
+															gs._input.isJoystickEvent = true;
+															gs._input.update(jsEvent);
+														},
+														 [&](const game::KeyEvent auto& keyEvent) { gs._input.update(keyEvent); },
+														 [&](const game::MouseButtonEvent auto& mouseEvent) { gs._input.update(mouseEvent); },
+														 [&](const game::Pressed<game::MouseButton>& press) {
+															 gs._input.update(press);
+															 if (press.source.button == sf::Mouse::Left) { gs._selected = gs.pick(press.source.mouse); }
+														 },
+														 [&](const game::Moved<game::Mouse>& move) { gs._hovered = gs.pick(move.source); },
+														 [&](const game::TimeElapsed& te) {
+															 GAME_ALLOC_SCOPE(Simulation);
+															 gs.advance(te.elapsed);
+														 },
+														 [&](const auto& /*unused*/) {} };
+	}
+
+	GameState::GameState()
+		: _player{ _world.create(Position{ 0.f, 0.f }, Velocity{ 0.f, 0.f }, PlayerControlled{ 200.f }, Shape{ 16.f, 16.f }) } {
+		_world.trackStructuralChanges(true);
+		rebuildSpatialIndex();
+		rebuildWorldHash();
+	}
+
+	std::uint64_t GameState::hash() {
+		return _input.hash.value() ^ worldHash()
+					 ^ StateHash::contribution(StateHash::slot(StateHash::Domain::Accumulated, 0),
+																		 static_cast<std::uint64_t>(_accumulated.count()))
+					 ^ StateHash::contribution(StateHash::slot(StateHash::Domain::Pointer, 0, 0), toValue(_hovered))
+					 ^ StateHash::contribution(StateHash::slot(StateHash::Domain::Pointer, 0, 1), toValue(_selected));
+	}
+
+	std::uint64_t GameState::worldHash() {
+		for (const auto& mask : _staleHashes) {
+			for (const auto& chunk : _world.chunks(mask)) { rehashChunk(*this, chunk); }
+		}
+		_staleHashes.clear();
+		return _worldHash.value();
+	}
+
+	std::uint64_t GameState::computeWorldHash() {
+		std::uint64_t result = 0;
+		for (const auto& chunk : _world.chunks(ComponentMask{})) {
+			for (const auto entity : chunk.entities()) {
+				result ^= StateHash::contribution(StateHash::slot(StateHash::Domain::Entity, entity.index),
+																					std::uint64_t{ entity.generation } + 1);
+			}
+		}
+		return result ^ vectorHash<Position>(_world, StateHash::Domain::Position)
+					 ^ vectorHash<Velocity>(_world, StateHash::Domain::Velocity);
+	}
+
+	void GameState::rebuildWorldHash() {
+		_worldHash.reset(0);
+		_entityHashes.clear();
+		_staleHashes.clear();
+		for (const auto& chunk : _world.chunks(ComponentMask{})) { rehashChunk(*this, chunk); }
+	}
+
+	void GameState::setHashing(const bool enabled) {
+		_input.hash.setEnabled(enabled);
+		_worldHash.setEnabled(enabled);
+		if (!enabled) { return; }
+		_input.hash.reset(_input.computeHash());
+		rebuildWorldHash();
+	}
+
+	std::optional<Entity> GameState::pick(const Mouse& mouse) const {
+		// there is no camera yet, world units are window pixels
+		std::optional<Entity> result;
+		_spatial.queryPoint(static_cast<float>(mouse.x), static_cast<float>(mouse.y), [&](const Entity entity) {
+			// the index lags behind entities destroyed or changed since the last tick
+			if (!_world.alive(entity) || _world.get<Shape>(entity) == nullptr) { return; }
+			if (!result || entity.index < result->index) { result = entity; }
+		});
+		return result;
+	}
+
+	void GameState::updateSpatialIndex() {
+		for (const auto entity : _world.structuralChanges()) {
+			const auto* position = _world.get<Position>(entity);
+			const auto* shape		 = _world.get<Shape>(entity);
+			if (position == nullptr || shape == nullptr) {
+				_spatial.remove(entity);
+			} else {
+				_spatial.update(entity, boundsOf(*position, *shape));
+			}
+		}
+		_world.clearStructuralChanges();
+
+		for (const auto& chunk : _world.chunks(componentMask<Position, Shape, Velocity>())) {
+			const auto entities	 = chunk.entities();
+			const auto positions = chunk.column<Position>();
+			const auto shapes		 = chunk.column<Shape>();
+			for (std::size_t row = 0; row < chunk.size(); ++row) {
+				const auto	bounds	= boundsOf(positions[row], shapes[row]);
+				const auto* current = _spatial.bounds(entities[row]);
+				if (current == nullptr || *current != bounds) { _spatial.update(entities[row], bounds); }
+			}
+		}
+	}
+
+	void GameState::rebuildSpatialIndex() {
+		_spatial.clear();
+		for (const auto& chunk : _world.chunks(componentMask<Position, Shape>())) {
+			const auto entities	 = chunk.entities();
+			const auto positions = chunk.column<Position>();
+			const auto shapes		 = chunk.column<Shape>();
+			for (std::size_t row = 0; row < chunk.size(); ++row) {
+				_spatial.update(entities[row], boundsOf(positions[row], shapes[row]));
+			}
+		}
+		_world.clearStructuralChanges();
+	}
+
+	void GameState::advance(const Clock::duration elapsed) {
+		_accumulated += elapsed;
+		if (_accumulated < TickDuration) { return; }
+		while (_accumulated >= TickDuration) {
+			_accumulated -= TickDuration;
+			_input.tick();
+			_systems.run(_world, _scheduler, SystemContext{ TickDuration, _input });
+		}
+		if (_worldHash.enabled()) {
+			const auto hashed = componentMask<Position, Velocity>();
+			for (const auto& system : _systems.systems()) {
+				const auto written = system.reads | system.writes;
+				if ((system.writes & hashed).none()
+						|| std::find(_staleHashes.begin(), _staleHashes.end(), written) != _staleHashes.end()) {
+					continue;
+				}
+				_staleHashes.push_back(written);
+			}
+		}
+		hashStructuralChanges(*this);
+		updateSpatialIndex();
+	}
+
+	void GameState::save(Snapshot& snapshot) const {
+		snapshot.input				= _input;
+		snapshot.world				= _world;
+		snapshot.player				= _player;
+		snapshot.hovered			= _hovered;
+		snapshot.selected			= _selected;
+		snapshot.accumulated	= _accumulated;
+		snapshot.worldHash		= _worldHash;
+		snapshot.entityHashes	= _entityHashes;
+		snapshot.staleHashes	= _staleHashes;
+	}
+
+	void GameState::restore(const Snapshot& snapshot) {
+		_input				= snapshot.input;
+		_world				= snapshot.world;
+		_player				= snapshot.player;
+		_hovered			= snapshot.hovered;
+		_selected			= snapshot.selected;
+		_accumulated	= snapshot.accumulated;
+		_worldHash		= snapshot.worldHash;
+		_entityHashes	= snapshot.entityHashes;
+		_staleHashes	= snapshot.staleHashes;
+		hashStructuralChanges(*this);
+		rebuildSpatialIndex();
+	}
+
 	void GameState::processEvent(const Event& ev) {
-		std::visit(game::overloaded{ [&](const game::JoystickEvent auto& jsEvent) {
-																	_input.isJoystickEvent = true;
-																	_input.update(jsEvent);
-																},
-																 [&](const auto& event) {} },
-							 ev);
-	}
-}// namespace game
\ No newline at end of file
+		GAME_ALLOC_SCOPE(Input);
+		std::visit(eventHandlers(*this), ev);
+	}
+
+	void GameState::processEvent(const PackedEvent& ev) {
+		GAME_ALLOC_SCOPE(Input);
+		game::visit(eventHandlers(*this), ev);
+	}
+}// namespace game
@@ -1,12 +1,82 @@
 #pragma once
+#include "ecs.h"
 #include "event.h"
+#include "event_packed.h"
 #include "input.h"
+#include "job_scheduler.h"
+#include "spatial_grid.h"
+#include "systems.h"
+#include <cstdint>
+#include <optional>
+#include <vector>
 
 namespace game {
 	struct GameState {
-		InputHandler _input;
+		// What the simulation changes, the spatial index is rebuilt from the world on restore
+		struct Snapshot {
+			InputHandler							 input;
+			World											 world;
+			Entity										 player;
+			std::optional<Entity>			 hovered;
+			std::optional<Entity>			 selected;
+			Clock::duration						 accumulated{};
+			StateHash									 worldHash;
+			std::vector<std::uint64_t> entityHashes;
+			std::vector<ComponentMask> staleHashes;
+		};
+
+		InputHandler	 _input;
+		World					 _world;
+		SystemSchedule _systems = defaultSystems();
+		// Not owned. Without one the systems run on the thread that processes events.
+		JobScheduler*	 _scheduler = nullptr;
+		Entity				 _player;
+		// Bounds of every entity with Position and Shape, as of the last tick
+		SpatialGrid						_spatial;
+		std::optional<Entity> _hovered;
+		std::optional<Entity> _selected;
+		// Elapsed time not yet simulated, always less than TickDuration
+		Clock::duration _accumulated{};
+		// World part of hash(): the xor of _entityHashes, the contribution of every entity by index. Structural changes
+		// are applied after every step, entities the systems wrote are rehashed when the hash is asked for.
+		StateHash									 _worldHash;
+		std::vector<std::uint64_t> _entityHashes;
+		// Chunks matching one of these may hold entities whose Position or Velocity changed since they were last hashed
+		std::vector<ComponentMask> _staleHashes;
+
+		GameState();
+
+		// Entity under the point, the one with the lowest index wins. Indices are reused, so this is not creation order.
+		[[nodiscard]] std::optional<Entity> pick(const Mouse& mouse) const;
+		// Follows the world's structural changes and the entities that can move, those with a Velocity. Positions of
+		// other entities written from outside the systems are not noticed until their components change.
+		void updateSpatialIndex();
+		void rebuildSpatialIndex();
+		// Brings _worldHash up to date with the world and returns it
+		[[nodiscard]] std::uint64_t worldHash();
+		// Full recomputation of the world hash from the entity set, positions and velocities, for verifying the
+		// incremental updates
+		[[nodiscard]] std::uint64_t computeWorldHash();
+		void												rebuildWorldHash();
+		// Hashing is on by default. Turning it back on rebuilds the hashes from the state.
+		void setHashing(bool enabled);
+
+		// Runs one fixed step per TickDuration of accumulated time. There is no cap on the number of steps here, a cap
+		// would make the result depend on how the recorder merged TimeElapsed events. Live sessions cap each
+		// TimeElapsed where it is measured, in EventHandler, before it is recorded.
+		void advance(Clock::duration elapsed);
+
+		// Assignments into the snapshot reuse the memory it holds from earlier saves
+		void save(Snapshot& snapshot) const;
+		void restore(const Snapshot& snapshot);
 
 		void processEvent(const Event& ev);
+		void processEvent(const PackedEvent& ev);
+
+		// Hash of everything that decides how the game continues: the input state, see InputHandler::hash, the world as
+		// of the last step, the time not yet simulated and what the mouse points at. Not free, it rehashes the entities
+		// the systems wrote since the last call.
+		[[nodiscard]] std::uint64_t hash();
 	};
 
 }// namespace game
@@ -0,0 +1,128 @@
+#pragma once
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace game {
+
+	// Lazy single pass sequence produced by a coroutine. Values are handed out by reference to the object named in
+	// co_yield, which stays alive until the consumer asks for the next one, so consumers may modify it in place.
+	template<typename T>
+	class Generator {
+	public:
+		struct promise_type {
+			T*								 current = nullptr;
+			std::exception_ptr exception;
+
+			Generator get_return_object() {
+				return Generator{ std::coroutine_handle<promise_type>::from_promise(*this) };
+			}
+
+			std::suspend_always initial_suspend() noexcept {
+				return {};
+			}
+
+			std::suspend_always final_suspend() noexcept {
+				return {};
+			}
+
+			std::suspend_always yield_value(T& value) noexcept {
+				current = std::addressof(value);
+				return {};
+			}
+
+			std::suspend_always yield_value(T&& value) noexcept {
+				current = std::addressof(value);
+				return {};
+			}
+
+			void return_void() noexcept {}
+
+			void unhandled_exception() noexcept {
+				exception = std::current_exception();
+			}
+
+			// generators only yield, awaiting inside of one is a mistake
+			template<typename Awaitable>
+			std::suspend_never await_transform(Awaitable&&) = delete;
+		};
+
+		class iterator {
+		private:
+			std::coroutine_handle<promise_type> _coroutine;
+
+		public:
+			using iterator_concept = std::input_iterator_tag;
+			using difference_type	 = std::ptrdiff_t;
+			using value_type			 = T;
+
+			iterator() = default;
+			explicit iterator(std::coroutine_handle<promise_type> coroutine)
+				: _coroutine{ coroutine } {}
+
+			T& operator*() const {
+				return *_coroutine.promise().current;
+			}
+
+			iterator& operator++() {
+				_coroutine.resume();
+				rethrow();
+				return *this;
+			}
+
+			void operator++(int) {
+				++*this;
+			}
+
+			bool operator==(std::default_sentinel_t /*unused*/) const {
+				return !_coroutine || _coroutine.done();
+			}
+
+			void rethrow() const {
+				if (_coroutine.done() && _coroutine.promise().exception) {
+					std::rethrow_exception(_coroutine.promise().exception);
+				}
+			}
+		};
+
+	private:
+		std::coroutine_handle<promise_type> _coroutine;
+
+		explicit Generator(std::coroutine_handle<promise_type> coroutine)
+			: _coroutine{ coroutine } {}
+
+	public:
+		Generator(Generator&& other) noexcept
+			: _coroutine{ std::exchange(other._coroutine, nullptr) } {}
+
+		Generator& operator=(Generator&& other) noexcept {
+			if (this != &other) {
+				if (_coroutine) { _coroutine.destroy(); }
+				_coroutine = std::exchange(other._coroutine, nullptr);
+			}
+			return *this;
+		}
+
+		Generator(const Generator&) = delete;
+		Generator& operator=(const Generator&) = delete;
+
+		~Generator() {
+			if (_coroutine) { _coroutine.destroy(); }
+		}
+
+		// Starts the coroutine, a generator can only be iterated once
+		iterator begin() {
+			iterator it{ _coroutine };
+			if (_coroutine) { ++it; }
+			return it;
+		}
+
+		std::default_sentinel_t end() const noexcept {
+			return {};
+		}
+	};
+
+}// namespace game
@@ -1,8 +1,13 @@
 #pragma once
 
 #include "event.h"
+#include "input_actions.h"
 #include "input_joystick.h"
+#include "state_hash.h"
 #include <array>
+#include <bitset>
+#include <cstdint>
+#include <limits>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -14,20 +19,232 @@ namespace game {
 	struct InputHandler {
 		bool				 isJoystickEvent = false;
 		JoystickList joysticks{};
+		ActionState	 actions{};
+		// Keys and mouse buttons that are down, so repeated presses are not counted as another holder of their action
+		std::bitset<sf::Keyboard::KeyCount> keysDown;
+		std::bitset<sf::Mouse::ButtonCount> mouseButtonsDown;
+		// Incremental hash of joysticks and the action state, edges included: systems read them in the next step
+		StateHash hash{};
+
+		// Joysticks only exist between Connected and Disconnected, events for other ids are ignored
+		void update(const Connected<JoystickDevice>& device) {
+			// a replug the device manager saw as one change, the old connection is released first
+			update(Disconnected<JoystickDevice>{ device.source });
+			joysticks.connect(device.source.id, device.source.buttonCount);
+			hash.update(connectedSlot(device.source.id), false, true);
+		};
+
+		// Held buttons and directions are released like the inputs themselves were, so their actions let go
+		void update(const Disconnected<JoystickDevice>& device) {
+			auto* js = connectedJoystick(device.source.id);
+			if (js == nullptr) { return; }
+			for (unsigned int button = 0; button < js->buttonCount; ++button) {
+				if (setButton(*js, button, false)) { releaseAction(_actionMap.lookup(JoystickButton{ js->id, button })); }
+			}
+			for (unsigned int axis = 0; axis < js->axisPosition.size(); ++axis) {
+				moveAxis(*js, axis, 0.0f);
+			}
+			hash.update(connectedSlot(js->id), true, false);
+			js->connected		= false;
+			js->buttonCount = 0;
+		};
 
 		void update(const Pressed<JoystickButton>& button) {
-			auto& js																= joysticks.getById(button.source.id);
-			js.buttonState.at(button.source.button) = true;
+			auto* js = connectedJoystick(button.source.id);
+			if (js != nullptr && setButton(*js, button.source.button, true)) {
+				pressAction(_actionMap.lookup(button.source));
+			}
 		};
 
 		void update(const Released<JoystickButton>& button) {
-			auto& js																= joysticks.getById(button.source.id);
-			js.buttonState.at(button.source.button) = false;
+			auto* js = connectedJoystick(button.source.id);
+			if (js != nullptr && setButton(*js, button.source.button, false)) {
+				releaseAction(_actionMap.lookup(button.source));
+			}
 		};
 
 		void update(const Moved<JoystickAxis>& joy) {
-			auto& js														= joysticks.getById(joy.source.id);
-			js.axisPosition.at(joy.source.axis) = joy.source.position;
+			if (auto* js = connectedJoystick(joy.source.id); js != nullptr) { moveAxis(*js, joy.source.axis, joy.source.position); }
 		};
+
+		void update(const Pressed<Key>& key) {
+			if (hold(keysDown, key.source.key, true)) { pressAction(_actionMap.lookup(key.source)); }
+		};
+
+		void update(const Released<Key>& key) {
+			if (hold(keysDown, key.source.key, false)) { releaseAction(_actionMap.lookup(key.source)); }
+		};
+
+		void update(const Pressed<MouseButton>& button) {
+			if (hold(mouseButtonsDown, button.source.button, true)) { pressAction(_actionMap.lookup(button.source)); }
+		};
+
+		void update(const Released<MouseButton>& button) {
+			if (hold(mouseButtonsDown, button.source.button, false)) { releaseAction(_actionMap.lookup(button.source)); }
+		};
+
+		[[nodiscard]] const ActionMap& actionMap() const {
+			return _actionMap;
+		}
+
+		// Inputs that are held while their binding changes let go of the old action and hold the new one
+		void bind(const sf::Keyboard::Key key, const Action action) {
+			const auto held = isHeld(keysDown, key) ? 1U : 0U;
+			rebind(held, _actionMap.lookup(Key{ false, false, false, false, key }), action, [&] {
+				_actionMap.bind(key, action);
+			});
+		}
+
+		void bind(const sf::Mouse::Button button, const Action action) {
+			const auto held = isHeld(mouseButtonsDown, button) ? 1U : 0U;
+			rebind(held, _actionMap.lookup(MouseButton{ button, {} }), action, [&] { _actionMap.bind(button, action); });
+		}
+
+		void bindJoystickButton(const unsigned int button, const Action action) {
+			unsigned int held = 0;
+			for (const auto& js : joysticks) {
+				if (js.connected && button < js.buttonCount && js.buttonState[button]) { ++held; }
+			}
+			rebind(held, _actionMap.lookup(JoystickButton{ 0, button }), action, [&] {
+				_actionMap.bindJoystickButton(button, action);
+			});
+		}
+
+		void bind(const sf::Joystick::Axis axis, const AxisBinding binding) {
+			const auto index	 = static_cast<unsigned int>(axis);
+			const auto old		 = _actionMap.lookup(JoystickAxis{ 0, index, 0.f });
+			const auto moveAll = [&](const AxisBinding& from, const AxisBinding& to) {
+				for (const auto& js : joysticks) {
+					if (!js.connected || index >= js.axisPosition.size()) { continue; }
+					const auto position = js.axisPosition[index];
+					crossThreshold(from.negative, position <= -from.threshold, position <= -to.threshold);
+					crossThreshold(from.positive, position >= from.threshold, position >= to.threshold);
+				}
+			};
+			// release against the old thresholds, then press against the new ones
+			moveAll(old, AxisBinding{ old.negative, old.positive, std::numeric_limits<float>::infinity() });
+			_actionMap.bind(axis, binding);
+			moveAll(AxisBinding{ binding.negative, binding.positive, std::numeric_limits<float>::infinity() }, binding);
+		}
+
+		// Makes the edges collected since the last tick visible, once per fixed step
+		void tick() {
+			changeActions([&] { actions.tick(); });
+		}
+
+		// Full recomputation of hash, for verifying the incremental updates
+		[[nodiscard]] std::uint64_t computeHash() const {
+			return joysticksHash() ^ actionsHash();
+		}
+
+	private:
+		ActionMap _actionMap = defaultActionMap();
+
+		template<std::size_t Count, typename Index>
+		[[nodiscard]] static bool isHeld(const std::bitset<Count>& held, const Index index) {
+			const auto position = static_cast<std::size_t>(index);
+			return position < Count && held[position];
+		}
+
+		template<typename Bind>
+		void rebind(const unsigned int holders, const Action from, const Action to, const Bind& bind) {
+			for (unsigned int holder = 0; holder < holders; ++holder) { releaseAction(from); }
+			bind();
+			for (unsigned int holder = 0; holder < holders; ++holder) { pressAction(to); }
+		}
+
+		[[nodiscard]] std::uint64_t actionsHash() const {
+			std::uint64_t result = 0;
+			const auto		bits	 = actions.bits();
+			for (std::uint32_t index = 0; index < bits.size(); ++index) {
+				result ^= StateHash::contribution(StateHash::slot(StateHash::Domain::Action, 0, index), bits[index]);
+			}
+			return result;
+		}
+
+		template<typename Change>
+		void changeActions(const Change& change) {
+			if (!hash.enabled()) {
+				change();
+				return;
+			}
+			const auto before = actionsHash();
+			change();
+			hash.toggle(before ^ actionsHash());
+		}
+
+		// Returns whether the input changed, out of range inputs never do
+		template<std::size_t Count, typename Index>
+		static bool hold(std::bitset<Count>& held, const Index index, const bool down) {
+			const auto position = static_cast<std::size_t>(index);
+			if (position >= Count || held[position] == down) { return false; }
+			held[position] = down;
+			return true;
+		}
+
+		[[nodiscard]] static std::uint64_t connectedSlot(const unsigned int id) {
+			return StateHash::slot(StateHash::Domain::JoystickConnected, id);
+		}
+
+		[[nodiscard]] Joystick* connectedJoystick(const unsigned int id) {
+			auto* js = joysticks.find(id);
+			return js != nullptr && js->connected ? js : nullptr;
+		}
+
+		// Buttons the joystick reported it does not have are ignored
+		bool setButton(Joystick& js, const unsigned int button, const bool pressed) {
+			if (button >= js.buttonCount) { return false; }
+			auto& state = js.buttonState[button];
+			if (state == pressed) { return false; }
+			hash.update(StateHash::slot(StateHash::Domain::JoystickButton, js.id, button), state, pressed);
+			state = pressed;
+			return true;
+		}
+
+		// Directions are only pressed and released when the position crosses their threshold, so noise around the
+		// center does not release actions other inputs hold
+		void moveAxis(Joystick& js, const unsigned int axis, const float to) {
+			if (axis >= js.axisPosition.size()) { return; }
+			auto&			 position = js.axisPosition[axis];
+			const auto previous = position;
+			hash.update(StateHash::slot(StateHash::Domain::JoystickAxis, js.id, axis), position, to);
+			position					 = to;
+			const auto binding = _actionMap.lookup(JoystickAxis{ js.id, axis, to });
+			crossThreshold(binding.negative, previous <= -binding.threshold, position <= -binding.threshold);
+			crossThreshold(binding.positive, previous >= binding.threshold, position >= binding.threshold);
+		}
+
+		void pressAction(const Action action) {
+			changeActions([&] { actions.press(action); });
+		}
+
+		void releaseAction(const Action action) {
+			changeActions([&] { actions.release(action); });
+		}
+
+		void crossThreshold(const Action action, const bool wasBeyond, const bool isBeyond) {
+			if (wasBeyond == isBeyond) { return; }
+			if (isBeyond) {
+				pressAction(action);
+			} else {
+				releaseAction(action);
+			}
+		}
+
+		[[nodiscard]] std::uint64_t joysticksHash() const {
+			std::uint64_t result = 0;
+			for (const auto& js : joysticks) {
+				result ^= StateHash::contribution(connectedSlot(js.id), StateHash::toValue(js.connected));
+				for (unsigned int button = 0; button < js.buttonState.size(); ++button) {
+					result ^= StateHash::contribution(StateHash::slot(StateHash::Domain::JoystickButton, js.id, button),
+																						StateHash::toValue(js.buttonState[button]));
+				}
+				for (unsigned int axis = 0; axis < js.axisPosition.size(); ++axis) {
+					result ^= StateHash::contribution(StateHash::slot(StateHash::Domain::JoystickAxis, js.id, axis),
+																						StateHash::toValue(js.axisPosition[axis]));
+				}
+			}
+			return result;
+		}
 	};
 }// namespace game
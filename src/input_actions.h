@@ -0,0 +1,179 @@
+#pragma once
+#include "event.h"
+#include <SFML/Window/Joystick.hpp>
+#include <SFML/Window/Keyboard.hpp>
+#include <SFML/Window/Mouse.hpp>
+#include <array>
+#include <bitset>
+#include <cstdlib>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+namespace game {
+
+	// Action::None is a real slot: unbound inputs are written there and never queried, which keeps updates branch free
+	enum class Action : std::uint8_t { None, MoveUp, MoveDown, MoveLeft, MoveRight, Confirm, Cancel, Menu, Count };
+
+	constexpr std::size_t ActionCount = static_cast<std::size_t>(Action::Count);
+
+	constexpr std::string_view toString(const Action action) {
+		switch (action) {
+		case Action::None:
+			return "None";
+		case Action::MoveUp:
+			return "MoveUp";
+		case Action::MoveDown:
+			return "MoveDown";
+		case Action::MoveLeft:
+			return "MoveLeft";
+		case Action::MoveRight:
+			return "MoveRight";
+		case Action::Confirm:
+			return "Confirm";
+		case Action::Cancel:
+			return "Cancel";
+		case Action::Menu:
+			return "Menu";
+		case Action::Count:
+			break;
+		}
+		abort();
+	}
+
+	struct AxisBinding {
+		Action negative	 = Action::None;
+		Action positive	 = Action::None;
+		float	 threshold = 50.f;
+	};
+
+	// Lookup tables from raw inputs to actions. Joystick bindings apply to every joystick id.
+	class ActionMap {
+	private:
+		std::array<Action, sf::Keyboard::KeyCount>				 _keys{};
+		std::array<Action, sf::Mouse::ButtonCount>				 _mouseButtons{};
+		std::array<Action, sf::Joystick::ButtonCount>		 _joystickButtons{};
+		std::array<AxisBinding, sf::Joystick::AxisCount> _joystickAxes{};
+
+		template<typename Table, typename Index>
+		[[nodiscard]] static constexpr auto lookup(const Table& table, const Index index) {
+			using Value = typename Table::value_type;
+			return static_cast<std::size_t>(index) < table.size() ? table[static_cast<std::size_t>(index)] : Value{};
+		}
+
+	public:
+		constexpr void bind(const sf::Keyboard::Key key, const Action action) {
+			_keys.at(static_cast<std::size_t>(key)) = action;
+		}
+
+		constexpr void bind(const sf::Mouse::Button button, const Action action) {
+			_mouseButtons.at(static_cast<std::size_t>(button)) = action;
+		}
+
+		constexpr void bindJoystickButton(const unsigned int button, const Action action) {
+			_joystickButtons.at(button) = action;
+		}
+
+		constexpr void bind(const sf::Joystick::Axis axis, const AxisBinding binding) {
+			_joystickAxes.at(static_cast<std::size_t>(axis)) = binding;
+		}
+
+		[[nodiscard]] constexpr Action lookup(const Key& key) const {
+			return lookup(_keys, key.key);
+		}
+
+		[[nodiscard]] constexpr Action lookup(const MouseButton& button) const {
+			return lookup(_mouseButtons, button.button);
+		}
+
+		[[nodiscard]] constexpr Action lookup(const JoystickButton& button) const {
+			return lookup(_joystickButtons, button.button);
+		}
+
+		[[nodiscard]] constexpr AxisBinding lookup(const JoystickAxis& axis) const {
+			return lookup(_joystickAxes, axis.axis);
+		}
+	};
+
+	constexpr ActionMap defaultActionMap() {
+		ActionMap map;
+		map.bind(sf::Keyboard::W, Action::MoveUp);
+		map.bind(sf::Keyboard::S, Action::MoveDown);
+		map.bind(sf::Keyboard::A, Action::MoveLeft);
+		map.bind(sf::Keyboard::D, Action::MoveRight);
+		map.bind(sf::Keyboard::Up, Action::MoveUp);
+		map.bind(sf::Keyboard::Down, Action::MoveDown);
+		map.bind(sf::Keyboard::Left, Action::MoveLeft);
+		map.bind(sf::Keyboard::Right, Action::MoveRight);
+		map.bind(sf::Keyboard::Enter, Action::Confirm);
+		map.bind(sf::Keyboard::Space, Action::Confirm);
+		map.bind(sf::Keyboard::Escape, Action::Menu);
+
+		map.bind(sf::Mouse::Left, Action::Confirm);
+		map.bind(sf::Mouse::Right, Action::Cancel);
+
+		map.bindJoystickButton(0, Action::Confirm);
+		map.bindJoystickButton(1, Action::Cancel);
+		map.bindJoystickButton(7, Action::Menu);
+		map.bind(sf::Joystick::X, AxisBinding{ Action::MoveLeft, Action::MoveRight });
+		map.bind(sf::Joystick::Y, AxisBinding{ Action::MoveUp, Action::MoveDown });
+		return map;
+	}
+
+	// Dense action state. Edges collected between ticks become visible on tick() and stay for the whole tick.
+	// Several inputs can hold the same action, it is down while at least one of them is. Callers report every input
+	// once per transition, repeated presses of an input that is already down would keep the action held.
+	class ActionState {
+	private:
+		using Bits = std::bitset<ActionCount>;
+		std::array<std::uint16_t, ActionCount> _holders{};
+		Bits																	 _down;
+		Bits																	 _pressed;
+		Bits																	 _released;
+		Bits																	 _pendingPressed;
+		Bits																	 _pendingReleased;
+
+	public:
+		void press(const Action action) {
+			const auto index = static_cast<std::size_t>(action);
+			if (_holders[index]++ == 0) {
+				_pendingPressed[index] = true;
+				_down[index]					 = true;
+			}
+		}
+
+		void release(const Action action) {
+			const auto index = static_cast<std::size_t>(action);
+			if (_holders[index] == 0) { return; }
+			if (--_holders[index] == 0) {
+				_pendingReleased[index] = true;
+				_down[index]						= false;
+			}
+		}
+
+		void tick() {
+			_pressed	= std::exchange(_pendingPressed, Bits{});
+			_released = std::exchange(_pendingReleased, Bits{});
+		}
+
+		[[nodiscard]] bool isDown(const Action action) const {
+			return _down[static_cast<std::size_t>(action)];
+		}
+
+		[[nodiscard]] bool wasPressed(const Action action) const {
+			return _pressed[static_cast<std::size_t>(action)];
+		}
+
+		[[nodiscard]] bool wasReleased(const Action action) const {
+			return _released[static_cast<std::size_t>(action)];
+		}
+
+		// Down, pressed, released, pending pressed and pending released, one bit per action
+		[[nodiscard]] std::array<std::uint64_t, 5> bits() const {
+			static_assert(ActionCount <= 64);
+			return { _down.to_ullong(), _pressed.to_ullong(), _released.to_ullong(), _pendingPressed.to_ullong(),
+							 _pendingReleased.to_ullong() };
+		}
+	};
+
+}// namespace game
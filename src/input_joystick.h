@@ -1,7 +1,10 @@
 #pragma once
 #include <SFML/Window/Joystick.hpp>
+#include <algorithm>
 #include <array>
+#include <cstdlib>
 #include <iterator>
+#include <string_view>
 #include <vector>
 
 namespace game {
@@ -30,45 +33,32 @@ namespace game {
 
 	struct Joystick {
 		unsigned int																id;
-		std::string																	name;
 		unsigned int																buttonCount;
 		std::array<bool, sf::Joystick::ButtonCount> buttonState;
 		std::array<float, sf::Joystick::AxisCount>	axisPosition;
+		bool																				connected = false;
 	};
 
+	// Joysticks known from Connected events. Ids that never connected are not listed and their events are ignored.
 	struct JoystickList : public std::vector<Joystick> {
-	private:
-		static void updateJoystick(Joystick& js) {
-			sf::Joystick::update();
-
-			for (unsigned int button = 0; button < js.buttonCount; ++button) {
-				js.buttonState.at(button) = sf::Joystick::isButtonPressed(js.id, button);
-			}
-
-			for (unsigned int axis = 0; axis < sf::Joystick::AxisCount; ++axis) {
-				js.axisPosition.at(axis) = sf::Joystick::getAxisPosition(js.id, static_cast<sf::Joystick::Axis>(axis));
-			}
+	public:
+		[[nodiscard]] Joystick* find(const unsigned int id) {
+			auto joystick = std::find_if(std::begin(*this), std::end(*this), [id](const auto& j) { return j.id == id; });
+			return joystick == this->end() ? nullptr : &*joystick;
 		}
 
-		static Joystick loadJoystick(unsigned int id) {
-			const auto identification = sf::Joystick::getIdentification(id);
-			Joystick	 js{ id, static_cast<std::string>(identification.name), sf::Joystick::getButtonCount(id), {}, {} };
-			updateJoystick(js);
-
-			return js;
+		[[nodiscard]] const Joystick* find(const unsigned int id) const {
+			return const_cast<JoystickList&>(*this).find(id);
 		}
 
-	public:
-		Joystick& getById(unsigned int id) {
-			auto joystick = std::find_if(std::begin(*this), std::end(*this), [id](const auto& j) { return j.id == id; });
-
-			if (joystick == this->end()) {
-				this->push_back(loadJoystick(id));
-				return this->back();
-			} else {
-				return *joystick;
-			}
+		// A reconnect reuses the entry of the id, it was cleared on disconnect
+		Joystick& connect(const unsigned int id, const unsigned int buttonCount) {
+			auto* joystick = find(id);
+			if (joystick == nullptr) { joystick = &this->emplace_back(Joystick{ id, 0, {}, {} }); }
+			joystick->buttonCount = std::min<unsigned int>(buttonCount, sf::Joystick::ButtonCount);
+			joystick->connected		= true;
+			return *joystick;
 		}
 	};
 
-}// namespace game
\ No newline at end of file
+}// namespace game
@@ -0,0 +1,104 @@
+#include "job_scheduler.h"
+#include <algorithm>
+#include <optional>
+#include <utility>
+
+namespace game {
+	namespace {
+		thread_local const JobScheduler* currentScheduler = nullptr;
+		thread_local std::size_t				 currentQueue			= 0;
+	}// namespace
+
+	JobScheduler::JobScheduler(const std::size_t threadCount) {
+		const auto count = std::max<std::size_t>(1, threadCount);
+		for (std::size_t index = 0; index < count; ++index) { _queues.push_back(std::make_unique<Queue>()); }
+		for (std::size_t index = 1; index < count; ++index) {
+			_workers.emplace_back([this, index] { workerLoop(index); });
+		}
+	}
+
+	JobScheduler::~JobScheduler() {
+		{
+			std::scoped_lock lock{ _sleepMutex };
+			_stopping = true;
+		}
+		_wake.notify_all();
+	}
+
+	std::size_t JobScheduler::localQueue() const {
+		return currentScheduler == this ? currentQueue : 0;
+	}
+
+	bool JobScheduler::tryRun(const std::size_t queue) {
+		std::optional<Task> task;
+		for (std::size_t offset = 0; offset < _queues.size() && !task; ++offset) {
+			auto&						 victim = *_queues[(queue + offset) % _queues.size()];
+			std::scoped_lock lock{ victim.mutex };
+			if (victim.tasks.empty()) { continue; }
+			if (offset == 0) {
+				task = std::move(victim.tasks.back());
+				victim.tasks.pop_back();
+			} else {
+				task = std::move(victim.tasks.front());
+				victim.tasks.pop_front();
+			}
+		}
+		if (!task) { return false; }
+		--_queued;
+
+		try {
+			const alloc::Scope scope{ task->tag };
+			task->job();
+		} catch (...) {
+			std::scoped_lock lock{ task->group->_mutex };
+			if (!task->group->_exception) { task->group->_exception = std::current_exception(); }
+		}
+		task->group->_pending.fetch_sub(1, std::memory_order_release);
+		return true;
+	}
+
+	void JobScheduler::workerLoop(const std::size_t queue) {
+		currentScheduler = this;
+		currentQueue		 = queue;
+		while (true) {
+			if (tryRun(queue)) { continue; }
+
+			std::unique_lock lock{ _sleepMutex };
+			_wake.wait(lock, [&] { return _stopping || _queued.load() > 0; });
+			if (_stopping) { return; }
+		}
+	}
+
+	void JobScheduler::submit(Group& group, Job job) {
+		group._pending.fetch_add(1, std::memory_order_relaxed);
+		{
+			auto&						 queue = *_queues[localQueue()];
+			std::scoped_lock lock{ queue.mutex };
+			queue.tasks.push_back(Task{ std::move(job), &group, alloc::currentTag() });
+		}
+		++_queued;
+		// taking the lock orders this against a worker that checked _queued and is about to sleep
+		{ std::scoped_lock lock{ _sleepMutex }; }
+		_wake.notify_one();
+	}
+
+	void JobScheduler::wait(Group& group) {
+		const auto queue = localQueue();
+		while (group._pending.load(std::memory_order_acquire) != 0) {
+			if (!tryRun(queue)) { std::this_thread::yield(); }
+		}
+		if (group._exception) { std::rethrow_exception(std::exchange(group._exception, nullptr)); }
+	}
+
+	void JobScheduler::parallelFor(const std::size_t																	 count,
+																 const std::size_t																	 grain,
+																 const std::function<void(std::size_t, std::size_t)>& function) {
+		const auto step = std::max<std::size_t>(1, grain);
+		Group			 group;
+		for (std::size_t begin = 0; begin < count; begin += step) {
+			submit(group, [&function, begin, end = std::min(count, begin + step)] { function(begin, end); });
+		}
+		wait(group);
+	}
+
+}// namespace game
@@ -0,0 +1,79 @@
+#pragma once
+#include "alloc_tracker.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace game {
+
+	// Work stealing thread pool. Every thread owns a queue, it takes its own newest jobs first and steals the
+	// oldest jobs of others when it runs dry. Threads waiting for a group run jobs meanwhile, so jobs may wait on
+	// jobs they spawned without blocking a worker.
+	class JobScheduler {
+	public:
+		using Job = std::function<void()>;
+
+		// Jobs whose completion can be waited for together
+		class Group {
+		private:
+			friend class JobScheduler;
+			std::atomic<std::size_t> _pending{ 0 };
+			std::mutex							 _mutex;
+			std::exception_ptr			 _exception;
+		};
+
+	private:
+		struct Task {
+			Job				 job;
+			Group*		 group;
+			// jobs allocate on behalf of whoever submitted them
+			alloc::Tag tag;
+		};
+
+		struct Queue {
+			std::mutex			 mutex;
+			std::deque<Task> tasks;
+		};
+
+		// queue 0 belongs to threads outside of the pool, the workers own the rest
+		std::vector<std::unique_ptr<Queue>> _queues;
+		std::atomic<std::size_t>						_queued{ 0 };
+		std::mutex													_sleepMutex;
+		std::condition_variable							_wake;
+		bool																_stopping = false;
+		std::vector<std::jthread>						_workers;
+
+		[[nodiscard]] std::size_t localQueue() const;
+		[[nodiscard]] bool				tryRun(std::size_t queue);
+		void											workerLoop(std::size_t queue);
+
+	public:
+		// threadCount includes the thread that waits, a scheduler with one thread runs everything inside of wait
+		explicit JobScheduler(std::size_t threadCount = std::max(1U, std::thread::hardware_concurrency()));
+		~JobScheduler();
+
+		JobScheduler(const JobScheduler&) = delete;
+		JobScheduler& operator=(const JobScheduler&) = delete;
+
+		[[nodiscard]] std::size_t threadCount() const {
+			return _queues.size();
+		}
+
+		void submit(Group& group, Job job);
+
+		// Returns once every job of the group finished, rethrows the first exception one of them threw
+		void wait(Group& group);
+
+		// Calls function(begin, end) for consecutive ranges of at most grain indices and waits for all of them
+		void parallelFor(std::size_t count, std::size_t grain, const std::function<void(std::size_t, std::size_t)>& function);
+	};
+
+}// namespace game
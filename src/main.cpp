@@ -1,14 +1,22 @@
+#include "alloc_tracker.h"
+#include "device_manager.h"
 #include "event_handler.h"
+#include "event_pipeline.h"
 #include "event_recorder.h"
 #include "event_serialize.h"
 #include "game_state.h"
 #include "render.h"
+#include "replay_verifier.h"
 #include "utility.h"
 #include <array>
+#include <charconv>
+#include <cmath>
 #include <docopt/docopt.h>
 #include <fstream>
+#include <memory>
 #include <spdlog/spdlog.h>
 #include <string>
+#include <system_error>
 
 // 1. must be white line before Options
 // 2. must be two spaces between description and default
@@ -24,6 +32,10 @@ static constexpr auto USAGE =
 		--scale=<SCALE>			Scaling factor  [default: 1].
 		--version				Show version.
 		--replay=<EVENTFILE>	JSON file of events to play.
+		--replay-speed=<SPEED>	Replay speed from 0.25 to 16, or max for unthrottled  [default: 1].
+		--replay-paused			Start the replay paused.
+		--font=<FONTFILE>		TrueType font for the UI, ImGui's default font if not set.
+		--font-cache=<DIR>		Directory for rasterized font atlases  [default: fontcache].
 )";
 
 /*
@@ -48,38 +60,78 @@ int main(int argc, const char** argv) {
 	spdlog::set_level(spdlog::level::debug);
 	// Use the default logger (stdout, multi-threaded, colored)
 	spdlog::info("Starting ImGui + SFML");
-	game::Render render{ width, height, static_cast<float>(scale) };
+	const auto fontFile = args["--font"] ? args["--font"].asString() : std::string{};
+	game::Render render{ width, height, static_cast<float>(scale), args["--font-cache"].asString(), fontFile };
 
-	game::GameState			gs;
-	game::EventHandler	eventHandler;
-	game::EventRecorder recorder;
+	// polled by the event handler on this thread, SFML's joystick state is not thread safe so there is no start()
+	game::DeviceManager devices{ std::make_unique<game::SfmlDeviceBackend>() };
+
+	game::JobScheduler	 scheduler;
+	game::GameState			 gs;
+	game::EventHandler	 eventHandler;
+	game::EventRecorder	 recorder;
+	game::ReplayVerifier verifier;
+	gs._scheduler = &scheduler;
+	eventHandler.setDevices(&devices);
 	if (args["--replay"]) {
 		const auto			eventFile = args["--replay"].asString();
 		std::ifstream		ifs{ eventFile };
 		game::EventList initialEvents;
 		ifs >> initialEvents;
 		eventHandler.loadEvents(std::move(initialEvents));
-	}
 
-	while (render.isOpen()) {
+		const auto speed = args["--replay-speed"].asString();
+		auto&			 pacer = eventHandler.pacer();
+		if (speed == "max") {
+			pacer.setUnthrottled(true);
+		} else {
+			double		 value = 0;
+			const auto end	 = speed.data() + speed.size();
+			const auto [parsed, error] = std::from_chars(speed.data(), end, value);
+			if (error != std::errc{} || parsed != end || !std::isfinite(value)) {
+				spdlog::error("Replay speed '{}' is neither a number nor max.", speed);
+				abort();
+			}
+			pacer.setSpeed(value);
+			if (pacer.speed() != value) {
+				spdlog::warn("Replay speed {} is out of range, using {} instead.", value, pacer.speed());
+			}
+		}
+		pacer.setPaused(args["--replay-paused"].asBool());
+		eventHandler.setIdleFrame([&](const game::TimeElapsed& te) {
+			render.processEvent(te);
+			render.processRender(gs);
+		});
+	}
 
-		const auto event = eventHandler.getNextEvent(render);
-		recorder.processEvent(event);
-		render.processEvent(event);
-		gs.processEvent(event);
+	{
+		auto pipeline = game::batches(eventHandler, render)
+										| game::filter([](const game::Event& ev) { return !std::holds_alternative<std::monostate>(ev); })
+										| game::simulate(gs,
+																		 [&](const game::Event& ev) {
+																			 if (std::holds_alternative<game::Checkpoint>(ev)) { verifier.processEvent(ev, gs.hash()); }
+																		 })
+										| game::record(recorder, gs) | game::present(render, gs)
+										| game::offload([](const game::EventList& batch) {
+												GAME_ALLOC_SCOPE(Logging);
+												for (const auto& event : batch) {
+													std::visit(game::overloaded{ [&](const game::TimeElapsed& /*unused*/) {},
+																											 [&](const std::monostate& /*unused*/) {},
+																											 [&](const auto& ev) { spdlog::info("Process event: {}", ev.name); } },
+																		 event);
+												}
+											});
 
-		std::visit(game::overloaded{ [&](const game::TimeElapsed& te) {},
-																 [&](const std::monostate& /*unused*/) {},
-																 [&](const auto& event) {
-																	 // do nothing
-																	 spdlog::info("Process event: {}", event.name);
-																 } },
-							 event);
-		render.processRender(gs);
+		for ([[maybe_unused]] const auto& batch : pipeline) { game::alloc::endFrame(); }
 	}
 	render.shutdown();
 
 	recorder.printInfo();
+	game::alloc::printInfo();
+	if (args["--replay"]) {
+		verifier.printInfo();
+		eventHandler.pacer().printInfo();
+	}
 	recorder.serialize("events.json");
 
 
@@ -0,0 +1,91 @@
+#include "mapped_file.h"
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace game {
+	std::optional<MappedFile> MappedFile::open(const std::filesystem::path& path) {
+		MappedFile mapped;
+#ifdef _WIN32
+		mapped._file = CreateFileW(
+			path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (mapped._file == INVALID_HANDLE_VALUE) {
+			mapped._file = nullptr;
+			return {};
+		}
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(mapped._file, &size) || size.QuadPart == 0) { return {}; }
+		mapped._mapping = CreateFileMappingW(mapped._file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapped._mapping == nullptr) { return {}; }
+		const auto* view = MapViewOfFile(mapped._mapping, FILE_MAP_READ, 0, 0, 0);
+		if (view == nullptr) { return {}; }
+		mapped._data = static_cast<const std::uint8_t*>(view);
+		mapped._size = static_cast<std::size_t>(size.QuadPart);
+#else
+		const int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) { return {}; }
+		struct stat info {};
+		if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+			close(fd);
+			return {};
+		}
+		const auto size = static_cast<std::size_t>(info.st_size);
+		void*			 view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (view == MAP_FAILED) { return {}; }
+		mapped._data = static_cast<const std::uint8_t*>(view);
+		mapped._size = size;
+#endif
+		return mapped;
+	}
+
+	void MappedFile::unmap() {
+#ifdef _WIN32
+		if (_data != nullptr) { UnmapViewOfFile(_data); }
+		if (_mapping != nullptr) { CloseHandle(_mapping); }
+		if (_file != nullptr) { CloseHandle(_file); }
+		_mapping = nullptr;
+		_file		 = nullptr;
+#else
+		if (_data != nullptr) { munmap(const_cast<std::uint8_t*>(_data), _size); }
+#endif
+		_data = nullptr;
+		_size = 0;
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+		: _data{ std::exchange(other._data, nullptr) }
+		, _size{ std::exchange(other._size, 0) }
+#ifdef _WIN32
+		, _file{ std::exchange(other._file, nullptr) }
+		, _mapping{ std::exchange(other._mapping, nullptr) }
+#endif
+	{
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+		if (this != &other) {
+			unmap();
+			_data = std::exchange(other._data, nullptr);
+			_size = std::exchange(other._size, 0);
+#ifdef _WIN32
+			_file		 = std::exchange(other._file, nullptr);
+			_mapping = std::exchange(other._mapping, nullptr);
+#endif
+		}
+		return *this;
+	}
+
+	MappedFile::~MappedFile() {
+		unmap();
+	}
+}// namespace game
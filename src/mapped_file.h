@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+
+namespace game {
+
+	// Read-only memory mapping of a whole file
+	class MappedFile {
+	private:
+		const std::uint8_t* _data = nullptr;
+		std::size_t					_size = 0;
+#ifdef _WIN32
+		void* _file		 = nullptr;
+		void* _mapping = nullptr;
+#endif
+
+		MappedFile() = default;
+		void unmap();
+
+	public:
+		static std::optional<MappedFile> open(const std::filesystem::path& path);
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+		~MappedFile();
+
+		[[nodiscard]] std::span<const std::uint8_t> bytes() const {
+			return { _data, _size };
+		}
+	};
+
+}// namespace game
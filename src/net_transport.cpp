@@ -0,0 +1,57 @@
+#include "net_transport.h"
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+
+namespace game {
+	UdpTransport::UdpTransport(unsigned short localPort, sf::IpAddress remoteAddress, unsigned short remotePort)
+		: _remoteAddress{ remoteAddress }
+		, _remotePort{ remotePort } {
+		if (_socket.bind(localPort) != sf::Socket::Done) {
+			throw std::runtime_error(fmt::format("Unable to bind UDP port {}", localPort));
+		}
+		_socket.setBlocking(false);
+	}
+
+	void UdpTransport::send(std::span<const std::uint8_t> packet) {
+		if (_socket.send(packet.data(), packet.size(), _remoteAddress, _remotePort) != sf::Socket::Done) {
+			spdlog::warn("Dropped outgoing packet of {} bytes", packet.size());
+		}
+	}
+
+	std::optional<Packet> UdpTransport::receive() {
+		std::size_t		 received = 0;
+		sf::IpAddress	 sender;
+		unsigned short port = 0;
+		while (_socket.receive(_buffer.data(), _buffer.size(), received, sender, port) == sf::Socket::Done) {
+			// ignore strays from anyone but our peer
+			if (sender == _remoteAddress && port == _remotePort) {
+				return Packet(_buffer.begin(), std::next(_buffer.begin(), static_cast<std::ptrdiff_t>(received)));
+			}
+		}
+		return {};
+	}
+
+	LoopbackNetwork::LoopbackNetwork(LoopbackConfig config)
+		: _config{ config }
+		, _random{ config.seed }
+		, _endpoints{ Endpoint{ *this, 0 }, Endpoint{ *this, 1 } } {}
+
+	void LoopbackNetwork::Endpoint::send(std::span<const std::uint8_t> packet) {
+		auto& network = _network;
+		if (std::bernoulli_distribution{ network._config.lossRate }(network._random)) { return; }
+
+		const auto jitter = std::uniform_int_distribution<std::uint32_t>{ 0, network._config.jitterTicks }(network._random);
+		const auto deliverAt = network._now + network._config.latencyTicks + jitter;
+		network._inFlight.at(1 - _index).emplace(deliverAt, Packet(packet.begin(), packet.end()));
+	}
+
+	std::optional<Packet> LoopbackNetwork::Endpoint::receive() {
+		auto& queue = _network._inFlight.at(_index);
+		if (queue.empty() || queue.begin()->first > _network._now) { return {}; }
+
+		auto packet = std::move(queue.begin()->second);
+		queue.erase(queue.begin());
+		return packet;
+	}
+
+}// namespace game
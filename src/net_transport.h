@@ -0,0 +1,82 @@
+#pragma once
+#include <SFML/Network/IpAddress.hpp>
+#include <SFML/Network/UdpSocket.hpp>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace game {
+	using Packet = std::vector<std::uint8_t>;
+
+	// Unreliable datagram transport: packets may be lost, duplicated or reordered
+	class Transport {
+	public:
+		virtual ~Transport() = default;
+
+		virtual void												send(std::span<const std::uint8_t> packet) = 0;
+		[[nodiscard]] virtual std::optional<Packet> receive()															 = 0;
+	};
+
+	class UdpTransport : public Transport {
+	private:
+		sf::UdpSocket	 _socket;
+		sf::IpAddress	 _remoteAddress;
+		unsigned short _remotePort;
+		Packet				 _buffer = Packet(sf::UdpSocket::MaxDatagramSize);
+
+	public:
+		UdpTransport(unsigned short localPort, sf::IpAddress remoteAddress, unsigned short remotePort);
+
+		void												send(std::span<const std::uint8_t> packet) override;
+		[[nodiscard]] std::optional<Packet> receive() override;
+	};
+
+	struct LoopbackConfig {
+		std::uint32_t latencyTicks = 0;
+		std::uint32_t jitterTicks	 = 0;
+		double				lossRate		 = 0.0;
+		std::uint32_t seed				 = 0;
+	};
+
+	// In-process stand-in for a pair of UDP peers. Time is measured in network ticks advanced by tick().
+	class LoopbackNetwork {
+	private:
+		class Endpoint : public Transport {
+		private:
+			LoopbackNetwork& _network;
+			std::size_t			 _index;
+
+		public:
+			Endpoint(LoopbackNetwork& network, std::size_t index)
+				: _network{ network }
+				, _index{ index } {}
+
+			void												send(std::span<const std::uint8_t> packet) override;
+			[[nodiscard]] std::optional<Packet> receive() override;
+		};
+
+		LoopbackConfig																			_config;
+		std::mt19937																				_random;
+		std::uint64_t																				_now = 0;
+		std::array<Endpoint, 2>															_endpoints;
+		std::array<std::multimap<std::uint64_t, Packet>, 2> _inFlight;
+
+	public:
+		explicit LoopbackNetwork(LoopbackConfig config);
+		LoopbackNetwork(const LoopbackNetwork&) = delete;
+		LoopbackNetwork& operator=(const LoopbackNetwork&) = delete;
+
+		[[nodiscard]] Transport& endpoint(std::size_t index) {
+			return _endpoints.at(index);
+		}
+
+		void tick() {
+			++_now;
+		}
+	};
+
+}// namespace game
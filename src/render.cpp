@@ -1,11 +1,15 @@
 #include "render.h"
 #include "ImGuiHelpers.h"
+#include "alloc_tracker.h"
+#include "components.h"
 #include "event_sfml.h"
 #include "game_state.h"
+#include "replay_pacer.h"
 #include "utility.h"
 #include <fmt/format.h>
 #include <imgui-SFML.h>
 #include <imgui.h>
+#include <spdlog/spdlog.h>
 
 static constexpr std::array							roadMap = { "Create roadmap",
 																				"Create project",
@@ -31,7 +35,7 @@ namespace game {
 	}
 
 	void Render::processEvent(const Event& ev) {
-
+		GAME_ALLOC_SCOPE(Render);
 		if (const auto sfmlEvent = game::toSFMLEvent(ev); sfmlEvent) { ImGui::SFML::ProcessEvent(*sfmlEvent); }
 
 		_timeElapsed = false;
@@ -48,23 +52,48 @@ namespace game {
 							 ev);
 	}
 
-	Render::Render(int width, int height, float scale)
-		: window{ sf::VideoMode(static_cast<unsigned int>(width), static_cast<unsigned int>(height)), "ImGui + SFML = <3" } {
+	Render::Render(int													width,
+								 int													height,
+								 float												scale,
+								 const std::filesystem::path& fontCacheDirectory,
+								 const std::filesystem::path& fontFile)
+		: window{ sf::VideoMode(static_cast<unsigned int>(width), static_cast<unsigned int>(height)), "ImGui + SFML = <3" }
+		, _fontCache{ fontCacheDirectory } {
 		window.setFramerateLimit(FRAMERATE_LIMIT);
-		ImGui::SFML::Init(window);
-
-		const auto scale_factor = scale;
-		ImGui::GetStyle().ScaleAllSizes(scale_factor);
-		ImGui::GetIO().FontGlobalScale = scale_factor;
+		ImGui::SFML::Init(window, false);
+
+		// the font is rasterized at the target size instead of being stretched by FontGlobalScale
+		const auto start		 = Clock::now();
+		const bool fromCache = _fontCache.load(*ImGui::GetIO().Fonts, scale, fontFile);
+		ImGui::SFML::UpdateFontTexture();
+		spdlog::info("Font atlas for scale {} ready in {} us ({} cache)",
+								 scale,
+								 std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count(),
+								 fromCache ? "warm" : "cold");
+
+		ImGui::GetStyle().ScaleAllSizes(scale);
 	}
 
+	// Joysticks are read by the DeviceManager, the window's joystick events would report every change twice
 	std::optional<Event> Render::getEvent() {
 		sf::Event event{};
-		if (window.pollEvent(event)) { return toEvent(event); }
+		while (window.pollEvent(event)) {
+			switch (event.type) {
+			case sf::Event::JoystickButtonPressed:
+			case sf::Event::JoystickButtonReleased:
+			case sf::Event::JoystickMoved:
+			case sf::Event::JoystickConnected:
+			case sf::Event::JoystickDisconnected:
+				continue;
+			default:
+				return toEvent(event);
+			}
+		}
 		return {};
 	}
 
 	void Render::processRender(const GameState& gs) {
+		GAME_ALLOC_SCOPE(Render);
 		if (!_timeElapsed) {
 			// TODO : something more with a linear flow here
 			return;
@@ -81,6 +110,7 @@ namespace game {
 		// Joystick display
 		ImGui::Begin("Joystick");
 		if (!gs._input.joysticks.empty()) {
+			ImGuiHelper::Text("Joystick {}: {}", gs._input.joysticks[0].id, gs._input.joysticks[0].connected ? "connected" : "disconnected");
 			ImGuiHelper::Text("Joystick Event: {}", _isJoystickEvent);
 			_isJoystickEvent = false;
 			for (std::size_t button = 0; button < gs._input.joysticks[0].buttonCount; ++button) {
@@ -93,11 +123,90 @@ namespace game {
 			}
 		}
 		ImGui::End();
+
+		ImGui::Begin("World");
+		ImGuiHelper::Text("Entities: {}, archetypes: {}", gs._world.size(), gs._world.archetypeCount());
+		if (const auto* position = gs._world.get<Position>(gs._player); position != nullptr) {
+			ImGuiHelper::Text("Player: {:.1f}, {:.1f}", position->x, position->y);
+		}
+		ImGuiHelper::Text("Hovered: {}", gs._hovered ? fmt::format("#{}", gs._hovered->index) : "none");
+		ImGuiHelper::Text("Selected: {}", gs._selected ? fmt::format("#{}", gs._selected->index) : "none");
+		ImGui::End();
+
+		if (_replayPacer != nullptr) { processReplayControls(*_replayPacer); }
+#ifdef GAME_ALLOC_TRACKING
+		processAllocations();
+#endif
+
+		ImGui::Begin("Actions");
+		for (std::size_t actionIndex = 1; actionIndex < ActionCount; ++actionIndex) {
+			const auto action = static_cast<Action>(actionIndex);
+			ImGuiHelper::Text("{}: down {}, pressed {}, released {}",
+												toString(action),
+												gs._input.actions.isDown(action),
+												gs._input.actions.wasPressed(action),
+												gs._input.actions.wasReleased(action));
+		}
+		ImGui::End();
 		window.clear();
 		ImGui::SFML::Render(window);
 		window.display();
 	}
+	void Render::processReplayControls(ReplayPacer& pacer) {
+		ImGui::Begin("Replay");
+		if (ImGui::Button(pacer.paused() ? "Resume" : "Pause")) { pacer.setPaused(!pacer.paused()); }
+		if (pacer.paused()) {
+			ImGui::SameLine();
+			if (ImGui::Button("Step")) { pacer.step(); }
+		}
+
+		for (const auto speed : { 0.25, 0.5, 1.0, 2.0, 4.0, 8.0, 16.0 }) {
+			const auto label = fmt::format("{}{}x", speed == pacer.speed() && !pacer.unthrottled() ? "> " : "", speed);
+			if (ImGui::Button(label.c_str())) {
+				pacer.setUnthrottled(false);
+				pacer.setSpeed(speed);
+			}
+			ImGui::SameLine();
+		}
+		bool unthrottled = pacer.unthrottled();
+		if (ImGui::Checkbox("max", &unthrottled)) { pacer.setUnthrottled(unthrottled); }
+
+		const auto micros = [](const Clock::duration duration) {
+			return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+		};
+		const auto& stats = pacer.stats();
+		ImGuiHelper::Text("Pacing error: last {} us, mean {} us, max {} us",
+											micros(stats.lastError),
+											micros(stats.meanError()),
+											micros(stats.maxError));
+		ImGui::End();
+	}
+
+#ifdef GAME_ALLOC_TRACKING
+	// Counted while this very window is drawn, the render row includes its own formatting
+	void Render::processAllocations() {
+		const auto report = alloc::report();
+		ImGui::Begin("Allocations");
+		ImGuiHelper::Text("Frame {}: allocations, bytes, peak | total: allocations, bytes, held, peak", report.frames);
+		for (std::size_t index = 0; index < alloc::TagCount; ++index) {
+			const auto& [total, frame] = report.tags[index];
+			if (total.allocations == 0) { continue; }
+			ImGuiHelper::Text("{}: {}, {}, {} | {}, {}, {}, {}",
+												alloc::TagNames[index],
+												frame.allocations,
+												frame.bytes,
+												frame.peak,
+												total.allocations,
+												total.bytes,
+												total.live,
+												total.peak);
+		}
+		ImGui::End();
+	}
+#endif
+
 	void Render::shutdown() {
+		_fontCache.release(*ImGui::GetIO().Fonts);
 		ImGui::SFML::Shutdown();
 	}
 
@@ -1,17 +1,31 @@
 #pragma once
 #include "event.h"
+#include "font_atlas_cache.h"
 #include <SFML/Graphics/RenderWindow.hpp>
+#include <filesystem>
 #include <optional>
 namespace game {
 	struct GameState;
+	class ReplayPacer;
 	class Render {
 		const unsigned int FRAMERATE_LIMIT = 60;
 		sf::RenderWindow	 window;
 		bool							 _timeElapsed			= false;
 		bool							 _isJoystickEvent = false;
+		FontAtlasCache		 _fontCache;
+		ReplayPacer*			 _replayPacer = nullptr;
+
+		void processReplayControls(ReplayPacer& pacer);
+#ifdef GAME_ALLOC_TRACKING
+		void processAllocations();
+#endif
 
 	public:
-		Render(int width, int height, float scale);
+		Render(int													width,
+					 int													height,
+					 float												scale,
+					 const std::filesystem::path& fontCacheDirectory,
+					 const std::filesystem::path& fontFile = {});
 		void processEvent(const Event& ev);
 
 		bool isOpen() const {
@@ -20,6 +34,13 @@ namespace game {
 
 		[[maybe_unused]] std::optional<Event> getEvent();
 
+		// While a replay pacer is set it decides when frames happen, the framerate limit is lifted so fast replays are
+		// not capped at real time, and the replay controls are shown
+		void setReplayPacer(ReplayPacer* pacer) {
+			_replayPacer = pacer;
+			window.setFramerateLimit(pacer != nullptr ? 0 : FRAMERATE_LIMIT);
+		}
+
 		void processRender(const GameState& gs);
 
 		void shutdown();
@@ -0,0 +1,81 @@
+#include "replay_pacer.h"
+#include <algorithm>
+#include <spdlog/spdlog.h>
+#include <thread>
+
+namespace game {
+	ReplayPacer::ReplayPacer(const double					 speed,
+													 const bool						 unthrottled,
+													 const bool						 paused,
+													 const Clock::duration spinThreshold)
+		: _speed{ std::clamp(speed, MinSpeed, MaxSpeed) }
+		, _unthrottled{ unthrottled }
+		, _paused{ paused }
+		, _spinThreshold{ spinThreshold } {}
+
+	// Every change of pace starts a new time base, deadlines before it were computed for the old pace
+	void ReplayPacer::setSpeed(const double speed) {
+		_speed = std::clamp(speed, MinSpeed, MaxSpeed);
+		_timeBase.reset();
+	}
+
+	void ReplayPacer::setUnthrottled(const bool unthrottled) {
+		_unthrottled = unthrottled;
+		_timeBase.reset();
+	}
+
+	void ReplayPacer::setPaused(const bool paused) {
+		_paused				= paused;
+		_pendingSteps = 0;
+		_timeBase.reset();
+	}
+
+	Clock::time_point ReplayPacer::deadline(const Clock::duration elapsed) {
+		const auto now = Clock::now();
+		if (_unthrottled || _paused) { return now; }
+
+		if (!_timeBase) {
+			_timeBase	 = now;
+			_scheduled = Scheduled{};
+		}
+
+		auto due = *_timeBase + std::chrono::round<Clock::duration>(_scheduled + scaled(elapsed));
+		if (now - due > MaxLag) {
+			_timeBase = now - std::chrono::round<Clock::duration>(_scheduled + scaled(elapsed));
+			due				= now;
+		}
+		return due;
+	}
+
+	void ReplayPacer::wait(const Clock::duration elapsed) {
+		const auto throttled = !_unthrottled && !_paused;
+		const auto due			 = deadline(elapsed);
+
+		if (throttled) {
+			if (const auto sleep = due - _spinThreshold - Clock::now(); sleep > Clock::duration::zero()) {
+				std::this_thread::sleep_for(sleep);
+			}
+			while (Clock::now() < due) { std::this_thread::yield(); }
+
+			const auto error = Clock::now() - due;
+			++_stats.ticks;
+			_stats.totalError += error;
+			_stats.maxError	 = std::max(_stats.maxError, error);
+			_stats.lastError = error;
+			_scheduled += scaled(elapsed);
+		}
+
+		if (_pendingSteps > 0) { --_pendingSteps; }
+	}
+
+	void ReplayPacer::printInfo() const {
+		const auto micros = [](const Clock::duration duration) {
+			return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+		};
+		spdlog::info("Replay pacing: {} ticks, error mean {} us, max {} us",
+								 _stats.ticks,
+								 micros(_stats.meanError()),
+								 micros(_stats.maxError));
+	}
+
+}// namespace game
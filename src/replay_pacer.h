@@ -0,0 +1,97 @@
+#pragma once
+#include "event.h"
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace game {
+
+	// Plays recorded ticks back in real time. Deadlines are absolute: every tick is due at the start of the time base
+	// plus the recorded time replayed since then, so sleeping too long on one tick is made up on the next ones instead
+	// of adding up over the session. Waiting sleeps until shortly before the deadline and spins the rest, the OS
+	// sleep alone overshoots by up to a scheduler quantum.
+	class ReplayPacer {
+	public:
+		static constexpr double					 MinSpeed = 0.25;
+		static constexpr double					 MaxSpeed = 16.0;
+		// Further behind than this, e.g. after a hitch, the time base restarts instead of rushing to catch up
+		static constexpr Clock::duration MaxLag = std::chrono::milliseconds{ 250 };
+
+		// Lateness of ticks relative to their deadline
+		struct Stats {
+			std::uint64_t		ticks = 0;
+			Clock::duration totalError{};
+			Clock::duration maxError{};
+			Clock::duration lastError{};
+
+			[[nodiscard]] Clock::duration meanError() const {
+				return ticks == 0 ? Clock::duration{} : totalError / static_cast<Clock::rep>(ticks);
+			}
+		};
+
+	private:
+		using Scheduled = std::chrono::duration<double, Clock::period>;
+
+		double													 _speed;
+		bool														 _unthrottled;
+		bool														 _paused;
+		std::uint32_t										 _pendingSteps = 0;
+		Clock::duration									 _spinThreshold;
+		std::optional<Clock::time_point> _timeBase;
+		Scheduled												 _scheduled{};
+		Stats														 _stats;
+
+		[[nodiscard]] Scheduled scaled(Clock::duration elapsed) const {
+			return Scheduled{ elapsed } / _speed;
+		}
+
+	public:
+		explicit ReplayPacer(double					 speed				 = 1.0,
+												 bool						 unthrottled	 = false,
+												 bool						 paused				 = false,
+												 Clock::duration spinThreshold = std::chrono::milliseconds{ 2 });
+
+		// Clamped to [MinSpeed, MaxSpeed]
+		void setSpeed(double speed);
+
+		[[nodiscard]] double speed() const {
+			return _speed;
+		}
+
+		// Ticks are released as fast as they are asked for
+		void setUnthrottled(bool unthrottled);
+
+		[[nodiscard]] bool unthrottled() const {
+			return _unthrottled;
+		}
+
+		void setPaused(bool paused);
+
+		[[nodiscard]] bool paused() const {
+			return _paused;
+		}
+
+		// Lets one more tick through while paused
+		void step() {
+			++_pendingSteps;
+		}
+
+		// Whether the next tick may start at all
+		[[nodiscard]] bool ready() const {
+			return !_paused || _pendingSteps > 0;
+		}
+
+		// When a tick lasting elapsed in the recording is due. Starts a new time base if there is none.
+		[[nodiscard]] Clock::time_point deadline(Clock::duration elapsed);
+
+		// Blocks until the tick is due and moves the time base past it
+		void wait(Clock::duration elapsed);
+
+		[[nodiscard]] const Stats& stats() const {
+			return _stats;
+		}
+
+		void printInfo() const;
+	};
+
+}// namespace game
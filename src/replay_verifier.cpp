@@ -0,0 +1,33 @@
+#include "replay_verifier.h"
+#include "alloc_tracker.h"
+#include <spdlog/spdlog.h>
+
+namespace game {
+	void ReplayVerifier::processEvent(const Event& ev, const std::uint64_t hash) {
+		GAME_ALLOC_SCOPE(Replay);
+		const auto* checkpoint = std::get_if<Checkpoint>(&ev);
+		if (checkpoint == nullptr || _divergence) { return; }
+
+		++_checkpointsVerified;
+		if (checkpoint->hash == hash) {
+			_lastMatchingTick = checkpoint->tick;
+			return;
+		}
+
+		_divergence = Divergence{ _lastMatchingTick, checkpoint->tick, checkpoint->hash, hash };
+		spdlog::error("Replay diverged between tick {} and tick {}: expected state hash {:016x}, got {:016x}",
+									_lastMatchingTick,
+									checkpoint->tick,
+									checkpoint->hash,
+									hash);
+	}
+
+	void ReplayVerifier::printInfo() const {
+		if (_divergence) {
+			spdlog::error("Replay diverged, first bad tick is in ({}, {}]", _divergence->lastMatchingTick, _divergence->tick);
+		} else {
+			spdlog::info("Replay matched all {} checkpoints", _checkpointsVerified);
+		}
+	}
+
+}// namespace game
@@ -0,0 +1,40 @@
+#pragma once
+#include "event.h"
+#include <cstdint>
+#include <optional>
+
+namespace game {
+
+	// Checks the state hash against the checkpoints of a replayed recording. The first mismatch narrows a divergence
+	// down to the ticks between the last matching checkpoint and the failing one.
+	class ReplayVerifier {
+	public:
+		struct Divergence {
+			std::uint32_t lastMatchingTick;
+			std::uint32_t tick;
+			std::uint64_t expected;
+			std::uint64_t actual;
+		};
+
+	private:
+		std::uint32_t							_checkpointsVerified = 0;
+		std::uint32_t							_lastMatchingTick		 = 0;
+		std::optional<Divergence> _divergence;
+
+	public:
+		// hash is the state after ev and everything before it has been processed. Only checkpoints are checked, callers
+		// may skip computing the hash for other events.
+		void processEvent(const Event& ev, std::uint64_t hash);
+
+		[[nodiscard]] const std::optional<Divergence>& firstDivergence() const {
+			return _divergence;
+		}
+
+		[[nodiscard]] std::uint32_t checkpointsVerified() const {
+			return _checkpointsVerified;
+		}
+
+		void printInfo() const;
+	};
+
+}// namespace game
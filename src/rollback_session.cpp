@@ -0,0 +1,25 @@
+#include "rollback_session.h"
+#include "event_serialize.h"
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+namespace game {
+	Packet encode(const InputPacket& packet) {
+		const nlohmann::json j{ { "tick", packet.firstTick }, { "ack", packet.ack }, { "inputs", packet.inputs } };
+		return nlohmann::json::to_msgpack(j);
+	}
+
+	std::optional<InputPacket> decode(const Packet& packet) {
+		try {
+			const auto	j = nlohmann::json::from_msgpack(packet);
+			InputPacket result;
+			j.at("tick").get_to(result.firstTick);
+			j.at("ack").get_to(result.ack);
+			j.at("inputs").get_to(result.inputs);
+			return result;
+		} catch (const nlohmann::json::exception& e) {
+			spdlog::warn("Dropped malformed input packet: {}", e.what());
+			return {};
+		}
+	}
+}// namespace game
@@ -0,0 +1,215 @@
+#pragma once
+#include "event.h"
+#include "net_transport.h"
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace game {
+	// Inputs for ticks [firstTick, firstTick + inputs.size()) plus the number of remote ticks the sender has received
+	struct InputPacket {
+		std::uint32_t					 firstTick = 0;
+		std::uint32_t					 ack			 = 0;
+		std::vector<EventList> inputs;
+	};
+
+	[[nodiscard]] Packet										 encode(const InputPacket& packet);
+	[[nodiscard]] std::optional<InputPacket> decode(const Packet& packet);
+
+	struct RollbackStats {
+		std::uint64_t		ticks						 = 0;
+		std::uint64_t		stalls					 = 0;
+		std::uint64_t		rollbacks				 = 0;
+		std::uint64_t		resimulatedTicks = 0;
+		std::uint32_t		maxDepth				 = 0;
+		Clock::duration rollbackTime{};
+	};
+
+	template<typename State>
+	concept SimulationState = std::copyable<State> && requires(State state, const Event& ev) {
+		state.processEvent(ev);
+	};
+
+	// States that can save and restore the part of them that simulation changes, cheaper than copying all of it
+	template<typename State>
+	concept Snapshotting = requires(const State& state, State& target, typename State::Snapshot& snapshot) {
+		state.save(snapshot);
+		target.restore(std::as_const(snapshot));
+	};
+
+	namespace detail {
+		template<typename State>
+		struct Snapshots {
+			using Type = State;
+
+			static void save(const State& state, State& snapshot) {
+				snapshot = state;
+			}
+
+			static void restore(State& state, const State& snapshot) {
+				state = snapshot;
+			}
+		};
+
+		template<Snapshotting State>
+		struct Snapshots<State> {
+			using Type = typename State::Snapshot;
+
+			static void save(const State& state, Type& snapshot) {
+				state.save(snapshot);
+			}
+
+			static void restore(State& state, const Type& snapshot) {
+				state.restore(snapshot);
+			}
+		};
+	}// namespace detail
+
+	// Deterministic lockstep with rollback for two players.
+	// Remote input is predicted to be empty, which for the edge based event model means "holds the same input".
+	// A late remote input that is not empty restores the snapshot taken before its tick and re-simulates up to now.
+	template<SimulationState State>
+	class RollbackSession {
+	public:
+		static constexpr std::size_t PlayerCount = 2;
+		using States														 = std::array<State, PlayerCount>;
+
+	private:
+		using Snapshots = detail::Snapshots<State>;
+		using Snapshot	= std::array<typename Snapshots::Type, PlayerCount>;
+
+		std::size_t						 _localPlayer;
+		Transport&						 _transport;
+		std::uint32_t					 _maxRollback;
+		std::size_t						 _ringSize;
+		States								 _states{};
+		std::vector<Snapshot>	 _snapshots;
+		std::vector<EventList> _localInputs;
+		std::vector<EventList> _remoteInputs;
+		EventList							 _pendingLocal;
+		std::uint32_t					 _tick						= 0;
+		std::uint32_t					 _remoteConfirmed = 0;
+		std::uint32_t					 _remoteAck				= 0;
+		RollbackStats					 _stats;
+
+		[[nodiscard]] std::size_t slot(std::uint32_t tick) const {
+			return tick % _ringSize;
+		}
+
+		void simulate(std::uint32_t tick) {
+			for (std::size_t player = 0; player < PlayerCount; ++player) {
+				Snapshots::save(_states[player], _snapshots[slot(tick)][player]);
+			}
+
+			static const EventList predicted{};
+			const auto&						 remote = tick < _remoteConfirmed ? _remoteInputs[slot(tick)] : predicted;
+			for (std::size_t player = 0; player < PlayerCount; ++player) {
+				const auto& inputs = player == _localPlayer ? _localInputs[slot(tick)] : remote;
+				for (const auto& ev : inputs) { _states[player].processEvent(ev); }
+				_states[player].processEvent(TimeElapsed{ TickDuration });
+			}
+		}
+
+		void rollback(std::uint32_t fromTick) {
+			const auto start = Clock::now();
+			const auto depth = _tick - fromTick;
+
+			for (std::size_t player = 0; player < PlayerCount; ++player) {
+				Snapshots::restore(_states[player], _snapshots[slot(fromTick)][player]);
+			}
+			for (auto tick = fromTick; tick < _tick; ++tick) { simulate(tick); }
+
+			++_stats.rollbacks;
+			_stats.resimulatedTicks += depth;
+			_stats.maxDepth = std::max(_stats.maxDepth, depth);
+			_stats.rollbackTime += Clock::now() - start;
+		}
+
+		void receive() {
+			auto rollbackFrom = _tick;
+			while (auto raw = _transport.receive()) {
+				const auto packet = decode(*raw);
+				if (!packet) { continue; }
+
+				_remoteAck = std::max(_remoteAck, std::min(packet->ack, _tick));
+				for (std::uint32_t index = 0; index < packet->inputs.size(); ++index) {
+					const auto tick = packet->firstTick + index;
+					// only contiguous inputs are accepted, anything after a gap is resent by the peer anyway
+					if (tick != _remoteConfirmed) { continue; }
+
+					_remoteInputs[slot(tick)] = packet->inputs[index];
+					if (tick < _tick && !packet->inputs[index].empty()) { rollbackFrom = std::min(rollbackFrom, tick); }
+					++_remoteConfirmed;
+				}
+			}
+
+			if (rollbackFrom < _tick) { rollback(rollbackFrom); }
+		}
+
+		void send() {
+			InputPacket packet{ _remoteAck, _remoteConfirmed, {} };
+			for (auto tick = _remoteAck; tick < _tick; ++tick) { packet.inputs.push_back(_localInputs[slot(tick)]); }
+			_transport.send(encode(packet));
+		}
+
+	public:
+		RollbackSession(std::size_t localPlayer, Transport& transport, std::uint32_t maxRollback = 8)
+			: _localPlayer{ localPlayer }
+			, _transport{ transport }
+			, _maxRollback{ maxRollback }
+			, _ringSize{ 2 * (static_cast<std::size_t>(maxRollback) + 1) }
+			, _snapshots(_ringSize)
+			, _localInputs(_ringSize)
+			, _remoteInputs(_ringSize) {}
+
+		// Receives remote input, rolls back if needed and resends unacknowledged local input
+		void poll() {
+			receive();
+			send();
+		}
+
+		// Simulates the next tick with the given local input. Returns false while waiting for the remote peer,
+		// the input is then kept and applied on the next successful advance.
+		bool advance(const EventList& localInput) {
+			receive();
+			_pendingLocal.insert(_pendingLocal.end(), localInput.begin(), localInput.end());
+
+			const bool tooFarAhead = _tick >= _remoteConfirmed + _maxRollback;
+			const bool unacked		 = _tick >= _remoteAck + _maxRollback;
+			if (tooFarAhead || unacked) {
+				++_stats.stalls;
+				send();
+				return false;
+			}
+
+			_localInputs[slot(_tick)] = std::exchange(_pendingLocal, EventList{});
+			simulate(_tick);
+			++_tick;
+			++_stats.ticks;
+			send();
+			return true;
+		}
+
+		[[nodiscard]] const States& states() const {
+			return _states;
+		}
+
+		[[nodiscard]] std::uint32_t tick() const {
+			return _tick;
+		}
+
+		// Ticks below this one are simulated with final remote input and will not be rolled back
+		[[nodiscard]] std::uint32_t confirmedTick() const {
+			return std::min(_tick, _remoteConfirmed);
+		}
+
+		[[nodiscard]] const RollbackStats& stats() const {
+			return _stats;
+		}
+	};
+
+}// namespace game
@@ -0,0 +1,88 @@
+#include "spatial_grid.h"
+#include <algorithm>
+
+namespace game {
+	void SpatialGrid::link(const std::uint32_t index, const CellRange& cells) {
+		if (isOversized(cells)) {
+			_oversized.push_back(index);
+			return;
+		}
+		for (auto y = cells.minY; y <= cells.maxY; ++y) {
+			for (auto x = cells.minX; x <= cells.maxX; ++x) { _cells[key(x, y)].push_back(index); }
+		}
+	}
+
+	void SpatialGrid::unlink(const std::uint32_t index, const CellRange& cells) {
+		if (isOversized(cells)) {
+			std::erase(_oversized, index);
+			return;
+		}
+		for (auto y = cells.minY; y <= cells.maxY; ++y) {
+			for (auto x = cells.minX; x <= cells.maxX; ++x) {
+				const auto found = _cells.find(key(x, y));
+				if (found == _cells.end()) { continue; }
+
+				auto& indices = found->second;
+				if (const auto position = std::find(indices.begin(), indices.end(), index); position != indices.end()) {
+					*position = indices.back();
+					indices.pop_back();
+				}
+				if (indices.empty()) { _cells.erase(found); }
+			}
+		}
+	}
+
+	std::uint32_t SpatialGrid::nextStamp() const {
+		_stamps.resize(_objects.size(), 0);
+		if (++_stamp == 0) {
+			std::fill(_stamps.begin(), _stamps.end(), 0);
+			_stamp = 1;
+		}
+		return _stamp;
+	}
+
+	void SpatialGrid::update(const Entity entity, const Bounds& bounds) {
+		if (!bounds.isFinite()) {
+			remove(entity);
+			return;
+		}
+		if (entity.index >= _objects.size()) { _objects.resize(entity.index + std::size_t{ 1 }); }
+
+		auto&			 object = _objects[entity.index];
+		const auto cells	= cellsOf(bounds);
+		if (!object.present) {
+			object = Object{ entity, bounds, cells, true };
+			link(entity.index, cells);
+			++_size;
+			return;
+		}
+
+		// the index may have been reused by a new entity, the slot follows the newest one
+		object.entity = entity;
+		object.bounds = bounds;
+		if (object.cells == cells) { return; }
+		unlink(entity.index, object.cells);
+		link(entity.index, cells);
+		object.cells = cells;
+	}
+
+	void SpatialGrid::remove(const Entity entity) {
+		if (!contains(entity)) { return; }
+		auto& object = _objects[entity.index];
+		unlink(entity.index, object.cells);
+		object.present = false;
+		--_size;
+	}
+
+	void SpatialGrid::clear() {
+		_cells.clear();
+		_oversized.clear();
+		_objects.clear();
+		_size = 0;
+	}
+
+	bool SpatialGrid::contains(const Entity entity) const {
+		return entity.index < _objects.size() && _objects[entity.index].present && _objects[entity.index].entity == entity;
+	}
+
+}// namespace game
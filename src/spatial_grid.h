@@ -0,0 +1,182 @@
+#pragma once
+#include "ecs.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace game {
+
+	struct Bounds {
+		float minX;
+		float minY;
+		float maxX;
+		float maxY;
+
+		constexpr bool operator==(const Bounds&) const = default;
+
+		[[nodiscard]] constexpr bool contains(const float x, const float y) const {
+			return x >= minX && x <= maxX && y >= minY && y <= maxY;
+		}
+
+		[[nodiscard]] constexpr bool intersects(const Bounds& other) const {
+			return minX <= other.maxX && other.minX <= maxX && minY <= other.maxY && other.minY <= maxY;
+		}
+
+		[[nodiscard]] bool isFinite() const {
+			return std::isfinite(minX) && std::isfinite(minY) && std::isfinite(maxX) && std::isfinite(maxY);
+		}
+
+		[[nodiscard]] constexpr float distanceSquared(const float x, const float y) const {
+			const auto dx = x < minX ? minX - x : (x > maxX ? x - maxX : 0.f);
+			const auto dy = y < minY ? minY - y : (y > maxY ? y - maxY : 0.f);
+			return dx * dx + dy * dy;
+		}
+	};
+
+	// Uniform grid over entity bounds. Cells are created on demand, so the world has no fixed extent.
+	// An entity is listed in every cell its bounds overlap; moving within the same cells only rewrites its bounds.
+	// Queries are not thread safe, rect and radius queries share a scratch buffer for removing duplicates.
+	// Destroyed entities have to be removed explicitly. Objects spanning more than MaxLinkedCells cells are not listed in
+	// cells but checked by every query, so one huge entity cannot make updates walk millions of cells.
+	class SpatialGrid {
+	public:
+		static constexpr std::int64_t MaxLinkedCells = 256;
+
+	private:
+		struct CellRange {
+			std::int32_t minX;
+			std::int32_t minY;
+			std::int32_t maxX;
+			std::int32_t maxY;
+
+			constexpr bool operator==(const CellRange&) const = default;
+		};
+
+		struct Object {
+			Entity		entity;
+			Bounds		bounds{};
+			CellRange cells{};
+			bool			present = false;
+		};
+
+		float																									 _cellSize;
+		std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> _cells;
+		std::vector<std::uint32_t>																		 _oversized;
+		std::vector<Object>																		 _objects;
+		std::size_t																						 _size = 0;
+		mutable std::vector<std::uint32_t>										 _stamps;
+		mutable std::uint32_t																	 _stamp = 0;
+
+		[[nodiscard]] static constexpr std::uint64_t key(const std::int32_t x, const std::int32_t y) {
+			return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32U) | static_cast<std::uint32_t>(y);
+		}
+
+		// Coordinates beyond the range of cells land in the outermost ones, NaN in cell 0
+		[[nodiscard]] std::int32_t cell(const float coordinate) const {
+			constexpr double limit	= 1 << 30;
+			const auto			 scaled = std::floor(static_cast<double>(coordinate) / static_cast<double>(_cellSize));
+			return std::isnan(scaled) ? 0 : static_cast<std::int32_t>(std::clamp(scaled, -limit, limit));
+		}
+
+		[[nodiscard]] static bool isOversized(const CellRange& cells) {
+			const auto width	= std::int64_t{ cells.maxX } - cells.minX + 1;
+			const auto height = std::int64_t{ cells.maxY } - cells.minY + 1;
+			return width * height > MaxLinkedCells;
+		}
+
+		[[nodiscard]] CellRange cellsOf(const Bounds& bounds) const {
+			return { cell(bounds.minX), cell(bounds.minY), cell(bounds.maxX), cell(bounds.maxY) };
+		}
+
+		void link(std::uint32_t index, const CellRange& cells);
+		void unlink(std::uint32_t index, const CellRange& cells);
+		std::uint32_t nextStamp() const;
+
+		// Calls function once for every object listed in a cell overlapping area
+		template<typename Function>
+		void visitCandidates(const Bounds& area, Function&& function) const {
+			const auto cells = cellsOf(area);
+			const auto stamp = nextStamp();
+			const auto visit = [&](const std::vector<std::uint32_t>& indices) {
+				for (const auto index : indices) {
+					if (_stamps[index] == stamp) { continue; }
+					_stamps[index] = stamp;
+					function(_objects[index]);
+				}
+			};
+			visit(_oversized);
+
+			// a huge area would mostly probe empty cells, walking the occupied cells is cheaper then
+			const auto width	= static_cast<std::uint64_t>(static_cast<std::int64_t>(cells.maxX) - cells.minX + 1);
+			const auto height = static_cast<std::uint64_t>(static_cast<std::int64_t>(cells.maxY) - cells.minY + 1);
+			if (width > _cells.size() || height > _cells.size() || width * height > _cells.size()) {
+				for (const auto& [cellKey, indices] : _cells) {
+					const auto x = static_cast<std::int32_t>(static_cast<std::uint32_t>(cellKey >> 32U));
+					const auto y = static_cast<std::int32_t>(static_cast<std::uint32_t>(cellKey));
+					if (x >= cells.minX && x <= cells.maxX && y >= cells.minY && y <= cells.maxY) { visit(indices); }
+				}
+				return;
+			}
+
+			for (auto y = cells.minY; y <= cells.maxY; ++y) {
+				for (auto x = cells.minX; x <= cells.maxX; ++x) {
+					if (const auto found = _cells.find(key(x, y)); found != _cells.end()) { visit(found->second); }
+				}
+			}
+		}
+
+	public:
+		explicit SpatialGrid(float cellSize = 64.f)
+			: _cellSize{ cellSize } {}
+
+		// Inserts the entity or moves it to its new bounds. Bounds that are not finite cannot be found by any query, the
+		// entity is removed instead.
+		void update(Entity entity, const Bounds& bounds);
+		void remove(Entity entity);
+		void clear();
+
+		[[nodiscard]] bool contains(Entity entity) const;
+
+		// Where the entity is listed, nullptr if it is not
+		[[nodiscard]] const Bounds* bounds(Entity entity) const {
+			return contains(entity) ? &_objects[entity.index].bounds : nullptr;
+		}
+
+		[[nodiscard]] std::size_t size() const {
+			return _size;
+		}
+
+		[[nodiscard]] std::size_t cellCount() const {
+			return _cells.size();
+		}
+
+		template<typename Function>
+		void queryPoint(const float x, const float y, Function&& function) const {
+			const auto visit = [&](const std::vector<std::uint32_t>& indices) {
+				for (const auto index : indices) {
+					if (_objects[index].bounds.contains(x, y)) { function(_objects[index].entity); }
+				}
+			};
+			visit(_oversized);
+			if (const auto found = _cells.find(key(cell(x), cell(y))); found != _cells.end()) { visit(found->second); }
+		}
+
+		template<typename Function>
+		void queryRect(const Bounds& area, Function&& function) const {
+			visitCandidates(area, [&](const Object& object) {
+				if (object.bounds.intersects(area)) { function(object.entity); }
+			});
+		}
+
+		template<typename Function>
+		void queryRadius(const float x, const float y, const float radius, Function&& function) const {
+			const auto radiusSquared = radius * radius;
+			visitCandidates(Bounds{ x - radius, y - radius, x + radius, y + radius }, [&](const Object& object) {
+				if (object.bounds.distanceSquared(x, y) <= radiusSquared) { function(object.entity); }
+			});
+		}
+	};
+
+}// namespace game
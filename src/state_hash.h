@@ -0,0 +1,78 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+
+namespace game {
+
+	// Zobrist style hash: every slot of the state contributes mix(slot, value) and the hash is the xor of all contributions.
+	// Changing one value is two mixes, and default valued slots contribute nothing so new slots do not need to be announced.
+	class StateHash {
+	private:
+		std::uint64_t _value	 = 0;
+		bool					_enabled = true;
+
+		// splitmix64 finalizer
+		[[nodiscard]] static constexpr std::uint64_t mix(std::uint64_t x) {
+			x = (x ^ (x >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+			x = (x ^ (x >> 27U)) * 0x94d049bb133111ebULL;
+			return x ^ (x >> 31U);
+		}
+
+	public:
+		enum class Domain : std::uint8_t {
+			JoystickButton = 1,
+			JoystickAxis,
+			JoystickConnected,
+			Action,
+			Entity,
+			Position,
+			Velocity,
+			Pointer,
+			Accumulated
+		};
+
+		[[nodiscard]] static constexpr std::uint64_t slot(const Domain domain, const std::uint32_t id, const std::uint32_t index = 0) {
+			return (static_cast<std::uint64_t>(domain) << 56U) | (static_cast<std::uint64_t>(id) << 24U) | index;
+		}
+
+		[[nodiscard]] static constexpr std::uint64_t toValue(const bool value) {
+			return value ? 1U : 0U;
+		}
+
+		[[nodiscard]] static constexpr std::uint64_t toValue(const float value) {
+			return std::bit_cast<std::uint32_t>(value);
+		}
+
+		[[nodiscard]] static constexpr std::uint64_t contribution(const std::uint64_t slot, const std::uint64_t value) {
+			return value == 0 ? 0 : mix(mix(slot) + value);
+		}
+
+		template<typename Value>
+		constexpr void update(const std::uint64_t slot, const Value oldValue, const Value newValue) {
+			if (_enabled) { _value ^= contribution(slot, toValue(oldValue)) ^ contribution(slot, toValue(newValue)); }
+		}
+
+		// Adds or removes a precomputed set of contributions
+		constexpr void toggle(const std::uint64_t contributions) {
+			if (_enabled) { _value ^= contributions; }
+		}
+
+		// A disabled hash ignores updates and keeps a stale value until it is reset, for measuring what hashing costs
+		constexpr void setEnabled(const bool enabled) {
+			_enabled = enabled;
+		}
+
+		[[nodiscard]] constexpr bool enabled() const {
+			return _enabled;
+		}
+
+		constexpr void reset(const std::uint64_t value) {
+			_value = value;
+		}
+
+		[[nodiscard]] constexpr std::uint64_t value() const {
+			return _value;
+		}
+	};
+
+}// namespace game
@@ -0,0 +1,82 @@
+#include "systems.h"
+#include "components.h"
+#include "input.h"
+#include <algorithm>
+#include <chrono>
+
+namespace game {
+	namespace {
+		bool conflicts(const System& lhs, const System& rhs) {
+			return (lhs.writes & (rhs.reads | rhs.writes)).any() || (rhs.writes & lhs.reads).any();
+		}
+
+		float axis(const ActionState& actions, const Action negative, const Action positive) {
+			return (actions.isDown(positive) ? 1.f : 0.f) - (actions.isDown(negative) ? 1.f : 0.f);
+		}
+	}// namespace
+
+	void SystemSchedule::add(System system) {
+		std::size_t wave = 0;
+		for (std::size_t index = 0; index < _waves.size(); ++index) {
+			const bool conflicting = std::any_of(_waves[index].begin(), _waves[index].end(), [&](const auto other) {
+				return conflicts(system, _systems[other]);
+			});
+			if (conflicting) { wave = index + 1; }
+		}
+
+		if (wave == _waves.size()) { _waves.emplace_back(); }
+		_waves[wave].push_back(_systems.size());
+		_systems.push_back(std::move(system));
+	}
+
+	void SystemSchedule::run(World& world, JobScheduler* scheduler, const SystemContext& context) const {
+		for (const auto& wave : _waves) {
+			if (scheduler == nullptr || wave.size() == 1) {
+				for (const auto index : wave) { _systems[index].update(world, scheduler, context); }
+				continue;
+			}
+
+			JobScheduler::Group group;
+			for (const auto index : wave) {
+				scheduler->submit(group, [&, index] { _systems[index].update(world, scheduler, context); });
+			}
+			scheduler->wait(group);
+		}
+	}
+
+	System inputSystem() {
+		return System{ "input",
+									 componentMask<PlayerControlled>(),
+									 componentMask<Velocity>(),
+									 [](World& world, JobScheduler* scheduler, const SystemContext& context) {
+										 const auto& actions = context.input.actions;
+										 const auto	 x			 = axis(actions, Action::MoveLeft, Action::MoveRight);
+										 const auto	 y			 = axis(actions, Action::MoveUp, Action::MoveDown);
+										 parallelEach<PlayerControlled, Velocity>(
+											 world, scheduler, [&](const PlayerControlled& player, Velocity& velocity) {
+												 velocity = Velocity{ x * player.speed, y * player.speed };
+											 });
+									 } };
+	}
+
+	System movementSystem() {
+		return System{ "movement",
+									 componentMask<Velocity>(),
+									 componentMask<Position>(),
+									 [](World& world, JobScheduler* scheduler, const SystemContext& context) {
+										 const auto seconds = std::chrono::duration<float>{ context.elapsed }.count();
+										 parallelEach<Velocity, Position>(world, scheduler, [&](const Velocity& velocity, Position& position) {
+											 position.x += velocity.x * seconds;
+											 position.y += velocity.y * seconds;
+										 });
+									 } };
+	}
+
+	SystemSchedule defaultSystems() {
+		SystemSchedule schedule;
+		schedule.add(inputSystem());
+		schedule.add(movementSystem());
+		return schedule;
+	}
+
+}// namespace game
@@ -0,0 +1,78 @@
+#pragma once
+#include "ecs.h"
+#include "event.h"
+#include "job_scheduler.h"
+#include <functional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace game {
+	struct InputHandler;
+
+	struct SystemContext {
+		Clock::duration			elapsed;
+		const InputHandler& input;
+	};
+
+	// update only touches entities that have every component in reads and writes
+	struct System {
+		std::string																										 name;
+		ComponentMask																									 reads;
+		ComponentMask																									 writes;
+		std::function<void(World&, JobScheduler*, const SystemContext&)> update;
+	};
+
+	// Systems grouped into waves. Two systems conflict when one of them writes a component the other one reads or
+	// writes. Every system is put into the wave after the last one holding a conflicting system, so conflicting systems
+	// run in registration order and everything within a wave runs in parallel.
+	class SystemSchedule {
+	private:
+		std::vector<System>										_systems;
+		std::vector<std::vector<std::size_t>> _waves;
+
+	public:
+		void add(System system);
+
+		// Without a scheduler every system runs on the calling thread
+		void run(World& world, JobScheduler* scheduler, const SystemContext& context) const;
+
+		[[nodiscard]] const std::vector<System>& systems() const {
+			return _systems;
+		}
+
+		[[nodiscard]] const std::vector<std::vector<std::size_t>>& waves() const {
+			return _waves;
+		}
+	};
+
+	// Calls function with the components of every matching entity, chunks are spread over the scheduler's threads
+	template<Component... Ts, typename Function>
+	void parallelEach(World& world, JobScheduler* scheduler, Function&& function) {
+		const auto chunks = world.chunks(componentMask<Ts...>());
+		const auto run		= [&](std::size_t begin, std::size_t end) {
+			 for (auto index = begin; index < end; ++index) {
+				 const auto& chunk = chunks[index];
+				 std::apply(
+					 [&](auto... columns) {
+						 for (std::size_t row = 0; row < chunk.size(); ++row) { function(columns[row]...); }
+					 },
+					 std::tuple{ chunk.template column<Ts>()... });
+			 }
+		};
+
+		if (scheduler == nullptr || scheduler->threadCount() == 1) {
+			run(0, chunks.size());
+		} else {
+			scheduler->parallelFor(chunks.size(), 4, run);
+		}
+	}
+
+	// Applies the player's actions to velocities
+	System inputSystem();
+	// Integrates positions
+	System movementSystem();
+
+	SystemSchedule defaultSystems();
+
+}// namespace game
@@ -0,0 +1,112 @@
+#include <alloc_tracker.h>
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <job_scheduler.h>
+#include <memory>
+#include <vector>
+
+// Built into its own executable with GAME_ALLOC_TRACKING defined, see CMakeLists.txt
+static_assert(game::alloc::Enabled);
+
+namespace {
+  // Nothing but these tests allocates under the replay tag. Checks stay outside of the tagged scopes, Catch allocates
+  // while it reports them.
+  const game::alloc::TagReport &replayTag(const game::alloc::Report &report)
+  {
+    return report.tags[static_cast<std::size_t>(game::alloc::Tag::Replay)];
+  }
+}// namespace
+
+TEST_CASE("Allocations are charged to the innermost scope", "[alloc]")
+{
+  const auto before = replayTag(game::alloc::report()).total;
+  auto tag = game::alloc::Tag::Untagged;
+  game::alloc::Counters during;
+  {
+    const game::alloc::Scope scope{ game::alloc::Tag::Replay };
+    tag = game::alloc::currentTag();
+    auto held = std::make_unique<std::array<std::byte, 1000>>();
+    {
+      const game::alloc::Scope inner{ game::alloc::Tag::Render };
+      const auto elsewhere = std::make_unique<int>(1);
+    }
+    during = replayTag(game::alloc::report()).total;
+  }
+  REQUIRE(tag == game::alloc::Tag::Replay);
+  REQUIRE(during.allocations == before.allocations + 1);
+  REQUIRE(during.bytes == before.bytes + 1000);
+  REQUIRE(during.live == before.live + 1000);
+  REQUIRE(game::alloc::currentTag() == game::alloc::Tag::Untagged);
+
+  const auto after = replayTag(game::alloc::report()).total;
+  REQUIRE(after.frees == before.frees + 1);
+  REQUIRE(after.live == before.live);
+  REQUIRE(after.peak >= before.live + 1000);
+}
+
+TEST_CASE("Frame counters are closed by endFrame", "[alloc]")
+{
+  game::alloc::endFrame();
+  const auto frames = game::alloc::report().frames;
+  {
+    const game::alloc::Scope scope{ game::alloc::Tag::Replay };
+    std::vector<int> values;
+    values.reserve(256);
+    game::alloc::endFrame();
+  }
+  auto report = game::alloc::report();
+  REQUIRE(report.frames == frames + 1);
+  REQUIRE(replayTag(report).frame.allocations == 1);
+  REQUIRE(replayTag(report).frame.bytes == 256 * sizeof(int));
+  REQUIRE(replayTag(report).frame.peak >= 256 * sizeof(int));
+
+  // the vector was released in the frame after, which allocated nothing
+  game::alloc::endFrame();
+  report = game::alloc::report();
+  REQUIRE(replayTag(report).frame.allocations == 0);
+  REQUIRE(replayTag(report).frame.frees == 1);
+}
+
+TEST_CASE("Over aligned allocations keep their alignment", "[alloc]")
+{
+  struct alignas(256) Aligned
+  {
+    std::array<std::byte, 300> data;
+  };
+
+  const auto before = replayTag(game::alloc::report()).total;
+  std::uintptr_t single = 0;
+  std::uintptr_t array = 0;
+  {
+    const game::alloc::Scope scope{ game::alloc::Tag::Replay };
+    const auto singleBlock = std::make_unique<Aligned>();
+    const auto arrayBlock = std::make_unique<Aligned[]>(3);
+    single = reinterpret_cast<std::uintptr_t>(singleBlock.get());
+    array = reinterpret_cast<std::uintptr_t>(arrayBlock.get());
+  }
+  REQUIRE(single % 256 == 0);
+  REQUIRE(array % 256 == 0);
+  const auto after = replayTag(game::alloc::report()).total;
+  REQUIRE(after.allocations == before.allocations + 2);
+  REQUIRE(after.live == before.live);
+}
+
+TEST_CASE("Jobs allocate under the tag of the thread that submitted them", "[alloc]")
+{
+  game::JobScheduler scheduler{ 4 };
+  std::vector<std::unique_ptr<std::array<std::byte, 100>>> blocks(64);
+  std::vector<game::alloc::Tag> tags(64);
+  const auto before = replayTag(game::alloc::report()).total;
+  {
+    const game::alloc::Scope scope{ game::alloc::Tag::Replay };
+    scheduler.parallelFor(blocks.size(), 1, [&](std::size_t begin, std::size_t /*end*/) {
+      tags[begin] = game::alloc::currentTag();
+      blocks[begin] = std::make_unique<std::array<std::byte, 100>>();
+    });
+  }
+  const auto after = replayTag(game::alloc::report()).total;
+  // the scheduler's queues and job wrappers are charged to the submitter as well
+  REQUIRE(after.allocations >= before.allocations + blocks.size());
+  REQUIRE(after.live >= before.live + blocks.size() * 100);
+  REQUIRE(std::ranges::all_of(tags, [](const auto tag) { return tag == game::alloc::Tag::Replay; }));
+}
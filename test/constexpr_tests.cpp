@@ -1,4 +1,5 @@
 #include <catch2/catch.hpp>
+#include <input_actions.h>
 
 constexpr unsigned int Factorial(unsigned int number)
 {
@@ -12,3 +13,13 @@ TEST_CASE("Factorials are computed with constexpr", "[factorial]")
   STATIC_REQUIRE(Factorial(3) == 6);
   STATIC_REQUIRE(Factorial(10) == 3628800);
 }
+
+TEST_CASE("Default action bindings are built at compile time", "[input]")
+{
+  constexpr auto map = game::defaultActionMap();
+  STATIC_REQUIRE(map.lookup(game::Key{ false, false, false, false, sf::Keyboard::W }) == game::Action::MoveUp);
+  STATIC_REQUIRE(map.lookup(game::Key{ false, false, false, false, sf::Keyboard::Unknown }) == game::Action::None);
+  STATIC_REQUIRE(map.lookup(game::MouseButton{ sf::Mouse::Right, { 0, 0 } }) == game::Action::Cancel);
+  STATIC_REQUIRE(map.lookup(game::JoystickButton{ 0, 0 }) == game::Action::Confirm);
+  STATIC_REQUIRE(map.lookup(game::JoystickAxis{ 0, sf::Joystick::X, 0.f }).positive == game::Action::MoveRight);
+}
@@ -0,0 +1,146 @@
+#include <catch2/catch.hpp>
+#include <device_manager.h>
+#include <event_packed.h>
+#include <tuple>
+#include <vector>
+
+namespace {
+  game::FakeDeviceBackend &addBackend(std::unique_ptr<game::FakeDeviceBackend> &owner)
+  {
+    owner = std::make_unique<game::FakeDeviceBackend>();
+    return *owner;
+  }
+
+  // Events have no equality, their packed form does the comparing
+  std::vector<std::tuple<std::uint8_t, std::uint32_t, std::uint64_t>> packed(const game::EventList &events)
+  {
+    std::vector<std::tuple<std::uint8_t, std::uint32_t, std::uint64_t>> result;
+    for (const auto &ev : events) {
+      const auto p = game::pack(ev);
+      result.emplace_back(p.type, p.a, p.b);
+    }
+    return result;
+  }
+}// namespace
+
+TEST_CASE("Device manager publishes connects and disconnects", "[devices]")
+{
+  std::unique_ptr<game::FakeDeviceBackend> owner;
+  auto &backend = addBackend(owner);
+  game::DeviceManager devices{ std::move(owner) };
+
+  REQUIRE_FALSE(devices.refresh());
+
+  backend.connect(2, "Pad", 12);
+  backend.setButton(2, 3, true);
+  backend.setAxis(2, sf::Joystick::X, 75.f);
+  devices.pollOnce();
+  REQUIRE(devices.refresh());
+  const auto &connected = devices.current().joysticks.at(2);
+  REQUIRE(connected.connected);
+  REQUIRE(connected.connectionCount == 1);
+  REQUIRE(connected.name == "Pad");
+  REQUIRE(connected.buttonCount == 12);
+  REQUIRE(connected.buttonState.at(3));
+  REQUIRE(connected.axisPosition.at(sf::Joystick::X) == 75.f);
+
+  backend.disconnect(2);
+  devices.pollOnce();
+  REQUIRE(devices.refresh());
+  const auto &disconnected = devices.current().joysticks.at(2);
+  REQUIRE_FALSE(disconnected.connected);
+  REQUIRE(disconnected.connectionCount == 2);
+  REQUIRE(disconnected.buttonCount == 0);
+  REQUIRE_FALSE(disconnected.buttonState.at(3));
+}
+
+TEST_CASE("Only the newest snapshot is handed to the reader", "[devices]")
+{
+  std::unique_ptr<game::FakeDeviceBackend> owner;
+  addBackend(owner);
+  game::DeviceManager devices{ std::move(owner) };
+  devices.pollOnce();
+  devices.pollOnce();
+  devices.pollOnce();
+  REQUIRE(devices.refresh());
+  REQUIRE(devices.current().sequence == 3);
+  REQUIRE_FALSE(devices.refresh());
+}
+
+TEST_CASE("Device changes are turned into events", "[devices]")
+{
+  std::unique_ptr<game::FakeDeviceBackend> owner;
+  auto &backend = addBackend(owner);
+  game::DeviceManager devices{ std::move(owner) };
+  game::EventList events;
+
+  devices.pollEvents(events);
+  REQUIRE(events.empty());
+
+  backend.connect(0, "Pad", 16);
+  backend.setButton(0, 2, true);
+  devices.pollEvents(events);
+  REQUIRE(packed(events) == packed(game::EventList{ game::Connected<game::JoystickDevice>{ { 0, 16 } },
+                                            game::Pressed<game::JoystickButton>{ { 0, 2 } } }));
+
+  events.clear();
+  backend.setButton(0, 2, false);
+  backend.setAxis(0, sf::Joystick::Y, -40.f);
+  devices.pollEvents(events);
+  REQUIRE(packed(events) == packed(game::EventList{ game::Released<game::JoystickButton>{ { 0, 2 } },
+                                            game::Moved<game::JoystickAxis>{ { 0, sf::Joystick::Y, -40.f } } }));
+
+  events.clear();
+  devices.pollEvents(events);
+  REQUIRE(events.empty());
+
+  SECTION("Disconnecting reports the device gone")
+  {
+    backend.disconnect(0);
+    devices.pollEvents(events);
+    REQUIRE(packed(events) == packed(game::EventList{ game::Disconnected<game::JoystickDevice>{ { 0, 0 } } }));
+  }
+
+  SECTION("A replug between two polls starts from a released device")
+  {
+    backend.disconnect(0);
+    devices.pollOnce();
+    backend.connect(0, "Other pad", 4);
+    backend.setAxis(0, sf::Joystick::Y, -40.f);
+    devices.pollEvents(events);
+    REQUIRE(packed(events) == packed(game::EventList{ game::Disconnected<game::JoystickDevice>{ { 0, 0 } },
+                                              game::Connected<game::JoystickDevice>{ { 0, 4 } },
+                                              game::Moved<game::JoystickAxis>{ { 0, sf::Joystick::Y, -40.f } } }));
+  }
+}
+
+TEST_CASE("Background polling picks up a new device", "[devices]")
+{
+  std::unique_ptr<game::FakeDeviceBackend> owner;
+  auto &backend = addBackend(owner);
+  game::DeviceManager devices{ std::move(owner) };
+  devices.start(std::chrono::milliseconds{ 1 });
+  backend.connect(1, "Pad", 8);
+
+  const auto deadline = game::Clock::now() + std::chrono::seconds{ 5 };
+  bool seen = false;
+  while (!seen && game::Clock::now() < deadline) {
+    seen = devices.refresh() && devices.current().joysticks.at(1).connected;
+  }
+  REQUIRE(seen);
+}
+
+TEST_CASE("Device polling throughput", "[.][benchmark]")
+{
+  std::unique_ptr<game::FakeDeviceBackend> owner;
+  auto &backend = addBackend(owner);
+  for (unsigned int id = 0; id < sf::Joystick::Count; ++id) { backend.connect(id, "Pad", sf::Joystick::ButtonCount); }
+  game::DeviceManager devices{ std::move(owner) };
+
+  BENCHMARK("Poll and publish all devices") { devices.pollOnce(); };
+  BENCHMARK("Pick up the newest snapshot")
+  {
+    devices.pollOnce();
+    return devices.refresh();
+  };
+}
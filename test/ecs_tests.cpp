@@ -0,0 +1,232 @@
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <components.h>
+#include <ecs.h>
+#include <fmt/format.h>
+#include <game_state.h>
+#include <job_scheduler.h>
+#include <stdexcept>
+#include <systems.h>
+#include <thread>
+
+namespace {
+  struct Health
+  {
+    int value;
+  };
+
+  struct alignas(16) Transform
+  {
+    float matrix[4];
+  };
+
+  // Flattened view of every (Position, Velocity) entity, in iteration order
+  std::vector<std::pair<game::Entity, float>> positions(game::World &world)
+  {
+    std::vector<std::pair<game::Entity, float>> result;
+    for (const auto &chunk : world.chunks(game::componentMask<game::Position>())) {
+      const auto entities = chunk.entities();
+      const auto column = chunk.column<game::Position>();
+      for (std::size_t row = 0; row < chunk.size(); ++row) { result.emplace_back(entities[row], column[row].x); }
+    }
+    return result;
+  }
+}// namespace
+
+TEST_CASE("Entities keep their components through creation and destruction", "[ecs]")
+{
+  game::World world;
+  std::vector<game::Entity> entities;
+  for (int index = 0; index < 2000; ++index) {
+    entities.push_back(world.create(game::Position{ static_cast<float>(index), 0.f }, game::Velocity{ 1.f, 2.f }));
+  }
+  REQUIRE(world.size() == 2000);
+
+  // destroy every third entity, the holes are filled from the back
+  for (std::size_t index = 0; index < entities.size(); index += 3) { world.destroy(entities[index]); }
+  for (std::size_t index = 0; index < entities.size(); ++index) {
+    if (index % 3 == 0) {
+      REQUIRE_FALSE(world.alive(entities[index]));
+      REQUIRE(world.get<game::Position>(entities[index]) == nullptr);
+    } else {
+      REQUIRE(world.get<game::Position>(entities[index])->x == static_cast<float>(index));
+    }
+  }
+
+  const auto all = positions(world);
+  REQUIRE(all.size() == world.size());
+  for (const auto &[entity, x] : all) { REQUIRE(world.get<game::Position>(entity)->x == x); }
+
+  const auto reused = world.create(game::Position{ -1.f, -1.f });
+  REQUIRE(reused.index == entities[1998].index);
+  REQUIRE(reused.generation == 1);
+  REQUIRE(world.alive(reused));
+  REQUIRE_FALSE(world.alive(entities[1998]));
+  REQUIRE(world.get<game::Velocity>(reused) == nullptr);
+  REQUIRE(world.archetypeCount() == 2);
+}
+
+TEST_CASE("Adding and removing components moves entities between archetypes", "[ecs]")
+{
+  game::World world;
+  const auto first = world.create(game::Position{ 1.f, 2.f });
+  const auto second = world.create(game::Position{ 3.f, 4.f });
+
+  world.add(first, Health{ 10 });
+  world.add(first, Transform{ { 1.f, 2.f, 3.f, 4.f } });
+  REQUIRE(world.archetypeCount() == 3);
+  REQUIRE(world.get<game::Position>(first)->y == 2.f);
+  REQUIRE(world.get<Health>(first)->value == 10);
+  REQUIRE(world.get<Transform>(first)->matrix[3] == 4.f);
+  REQUIRE(reinterpret_cast<std::uintptr_t>(world.get<Transform>(first)) % 16 == 0);
+  REQUIRE(world.get<game::Position>(second)->x == 3.f);
+
+  world.add(first, Health{ 5 });
+  REQUIRE(world.get<Health>(first)->value == 5);
+
+  world.remove<game::Position>(first);
+  REQUIRE(world.get<game::Position>(first) == nullptr);
+  REQUIRE(world.get<Health>(first)->value == 5);
+  REQUIRE(world.get<game::Position>(second)->y == 4.f);
+
+  int visited = 0;
+  world.each<Health>([&](Health &health) {
+    ++health.value;
+    ++visited;
+  });
+  REQUIRE(visited == 1);
+  REQUIRE(world.get<Health>(first)->value == 6);
+}
+
+TEST_CASE("Copying a world copies its components", "[ecs]")
+{
+  game::World world;
+  const auto entity = world.create(game::Position{ 1.f, 1.f });
+  auto copy = world;
+  copy.get<game::Position>(entity)->x = 5.f;
+  REQUIRE(world.get<game::Position>(entity)->x == 1.f);
+  REQUIRE(copy.get<game::Position>(entity)->x == 5.f);
+}
+
+TEST_CASE("Structural changes are listed while tracked", "[ecs]")
+{
+  game::World world;
+  const auto untracked = world.create(game::Position{ 0.f, 0.f });
+  REQUIRE(world.structuralChanges().empty());
+
+  world.trackStructuralChanges(true);
+  const auto created = world.create(game::Position{ 1.f, 1.f });
+  world.get<game::Position>(untracked)->x = 5.f;
+  world.add(untracked, game::Velocity{ 1.f, 0.f });
+  world.remove<game::Shape>(created);
+  world.destroy(created);
+  REQUIRE(world.structuralChanges() == std::vector<game::Entity>{ created, untracked, created });
+
+  world.clearStructuralChanges();
+  REQUIRE(world.structuralChanges().empty());
+}
+
+TEST_CASE("Parallel for visits every index once", "[jobs]")
+{
+  const auto threads = GENERATE(1U, 2U, 4U);
+  game::JobScheduler scheduler{ threads };
+  REQUIRE(scheduler.threadCount() == threads);
+
+  std::vector<std::atomic<int>> visits(10'000);
+  scheduler.parallelFor(visits.size(), 7, [&](std::size_t begin, std::size_t end) {
+    for (auto index = begin; index < end; ++index) { ++visits[index]; }
+  });
+  REQUIRE(std::all_of(visits.begin(), visits.end(), [](const auto &count) { return count == 1; }));
+
+  // jobs waiting on their own jobs must not starve the pool
+  std::atomic<int> leaves{ 0 };
+  scheduler.parallelFor(16, 1, [&](std::size_t, std::size_t) {
+    scheduler.parallelFor(16, 1, [&](std::size_t, std::size_t) { ++leaves; });
+  });
+  REQUIRE(leaves == 256);
+}
+
+TEST_CASE("Exceptions in jobs are rethrown by wait", "[jobs]")
+{
+  game::JobScheduler scheduler{ 2 };
+  game::JobScheduler::Group group;
+  scheduler.submit(group, [] { throw std::runtime_error{ "job failed" }; });
+  scheduler.submit(group, [] {});
+  REQUIRE_THROWS_AS(scheduler.wait(group), std::runtime_error);
+}
+
+TEST_CASE("Systems are grouped into waves by their component access", "[ecs]")
+{
+  const auto noop = [](game::World &, game::JobScheduler *, const game::SystemContext &) {};
+  game::SystemSchedule schedule;
+  schedule.add({ "input", game::componentMask<game::PlayerControlled>(), game::componentMask<game::Velocity>(), noop });
+  schedule.add({ "health", game::componentMask<>(), game::componentMask<Health>(), noop });
+  schedule.add({ "movement", game::componentMask<game::Velocity>(), game::componentMask<game::Position>(), noop });
+  schedule.add({ "render", game::componentMask<game::Position, Health>(), game::componentMask<>(), noop });
+  schedule.add({ "friction", game::componentMask<>(), game::componentMask<game::Velocity>(), noop });
+
+  REQUIRE(schedule.waves() == std::vector<std::vector<std::size_t>>{ { 0, 1 }, { 2 }, { 3, 4 } });
+}
+
+TEST_CASE("Input moves the player through the systems", "[ecs]")
+{
+  game::JobScheduler scheduler{ 2 };
+  game::GameState gs;
+  gs._scheduler = &scheduler;
+
+  gs.processEvent(game::Pressed<game::Key>{ false, false, false, false, sf::Keyboard::D });
+  gs.processEvent(game::TimeElapsed{ std::chrono::seconds{ 1 } });
+  gs.processEvent(game::TimeElapsed{ std::chrono::seconds{ 1 } });
+  const auto *position = gs._world.get<game::Position>(gs._player);
+  REQUIRE(position->x == Approx(400.f));
+  REQUIRE(position->y == 0.f);
+
+  gs.processEvent(game::Released<game::Key>{ false, false, false, false, sf::Keyboard::D });
+  gs.processEvent(game::TimeElapsed{ std::chrono::seconds{ 1 } });
+  REQUIRE(gs._world.get<game::Position>(gs._player)->x == Approx(400.f));
+}
+
+TEST_CASE("The world does not depend on how elapsed time is split", "[ecs]")
+{
+  game::GameState split;
+  game::GameState merged;
+  for (auto *gs : { &split, &merged }) {
+    gs->processEvent(game::Pressed<game::Key>{ false, false, false, false, sf::Keyboard::S });
+  }
+
+  for (int frame = 0; frame < 90; ++frame) { split.processEvent(game::TimeElapsed{ std::chrono::milliseconds{ 11 } }); }
+  merged.processEvent(game::TimeElapsed{ std::chrono::milliseconds{ 11 * 90 } });
+
+  REQUIRE(split._accumulated == merged._accumulated);
+  REQUIRE(split._world.get<game::Position>(split._player)->y == merged._world.get<game::Position>(merged._player)->y);
+  REQUIRE(merged._world.get<game::Position>(merged._player)->y > 0.f);
+}
+
+TEST_CASE("Movement of 1M entities on 1 to N threads", "[.][benchmark]")
+{
+  game::World world;
+  for (int index = 0; index < 1'000'000; ++index) {
+    const auto value = static_cast<float>(index % 1000);
+    world.create(game::Position{ value, -value }, game::Velocity{ 1.f, 0.5f });
+  }
+  const game::InputHandler input;
+  const game::SystemContext context{ std::chrono::milliseconds{ 16 }, input };
+  const auto schedule = game::defaultSystems();
+
+  const auto maxThreads = std::max(4U, std::thread::hardware_concurrency());
+  for (unsigned int threads = 1; threads <= maxThreads; threads *= 2) {
+    game::JobScheduler scheduler{ threads };
+    constexpr int ticks = 20;
+    const auto start = std::chrono::steady_clock::now();
+    for (int tick = 0; tick < ticks; ++tick) { schedule.run(world, &scheduler, context); }
+    const auto perTick = std::chrono::duration<double, std::milli>{ std::chrono::steady_clock::now() - start } / ticks;
+    WARN(fmt::format("{} threads: {:.3f} ms per tick", threads, perTick.count()));
+
+    BENCHMARK(fmt::format("movement, {} threads", threads))
+    {
+      schedule.run(world, &scheduler, context);
+    };
+  }
+}
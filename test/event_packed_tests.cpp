@@ -0,0 +1,140 @@
+#include <catch2/catch.hpp>
+#include <event_packed.h>
+#include <fmt/format.h>
+#include <game_state.h>
+#include <random>
+
+namespace {
+  bool samePacked(const game::PackedEvent &lhs, const game::PackedEvent &rhs)
+  {
+    return lhs.type == rhs.type && lhs.flags == rhs.flags && lhs.a == rhs.a && lhs.b == rhs.b;
+  }
+
+  game::EventList sampleEvents()
+  {
+    return { std::monostate{},
+      game::Pressed<game::JoystickButton>{ 3, 31 },
+      game::Released<game::JoystickButton>{ 7, 0 },
+      game::Pressed<game::Key>{ true, false, true, false, sf::Keyboard::Escape },
+      game::Released<game::Key>{ false, true, false, true, sf::Keyboard::Unknown },
+      game::Moved<game::JoystickAxis>{ 1, sf::Joystick::PovY, -99.75f },
+      game::Moved<game::Mouse>{ -20, 4000 },
+      game::Pressed<game::MouseButton>{ sf::Mouse::Right, { -1, -2 } },
+      game::Released<game::MouseButton>{ sf::Mouse::Left, { 1920, 1080 } },
+      game::CloseWindow{},
+      game::TimeElapsed{ std::chrono::hours{ 24 * 365 } },
+      game::Checkpoint{ 600, 0xfedcba9876543210ULL },
+      game::Connected<game::JoystickDevice>{ { 7, 32 } },
+      game::Disconnected<game::JoystickDevice>{ { 2, 0 } } };
+  }
+}// namespace
+
+TEST_CASE("Packed events are 16 bytes", "[packed]")
+{
+  STATIC_REQUIRE(sizeof(game::PackedEvent) == 16);
+}
+
+TEST_CASE("Every event alternative survives packing", "[packed]")
+{
+  for (const auto &ev : sampleEvents()) {
+    const auto packed = game::pack(ev);
+    const auto unpacked = game::unpack(packed);
+    REQUIRE(unpacked.index() == ev.index());
+    REQUIRE(samePacked(game::pack(unpacked), packed));
+  }
+
+  const auto axis = std::get<game::Moved<game::JoystickAxis>>(game::unpack(game::pack(game::Moved<game::JoystickAxis>{ 1, 7, -99.75f })));
+  REQUIRE(axis.source.id == 1);
+  REQUIRE(axis.source.axis == 7);
+  REQUIRE(axis.source.position == -99.75f);
+
+  const auto key = std::get<game::Released<game::Key>>(game::unpack(game::pack(game::Released<game::Key>{ false, true, false, true, sf::Keyboard::Unknown })));
+  REQUIRE_FALSE(key.source.alt);
+  REQUIRE(key.source.control);
+  REQUIRE_FALSE(key.source.system);
+  REQUIRE(key.source.shift);
+  REQUIRE(key.source.key == sf::Keyboard::Unknown);
+
+  const auto button = std::get<game::Pressed<game::MouseButton>>(game::unpack(game::pack(game::Pressed<game::MouseButton>{ 2, { -1, -2 } })));
+  REQUIRE(button.source.button == 2);
+  REQUIRE(button.source.mouse.x == -1);
+  REQUIRE(button.source.mouse.y == -2);
+
+  const auto time = std::get<game::TimeElapsed>(game::unpack(game::pack(game::TimeElapsed{ std::chrono::hours{ 24 * 365 } })));
+  REQUIRE(time.elapsed == std::chrono::hours{ 24 * 365 });
+}
+
+TEST_CASE("Packed event lists convert back to the same events", "[packed]")
+{
+  const auto events = sampleEvents();
+  const game::PackedEventList packed{ events };
+  REQUIRE(packed.size() == events.size());
+
+  const auto restored = packed.toEventList();
+  REQUIRE(restored.size() == events.size());
+  for (std::size_t index = 0; index < events.size(); ++index) {
+    REQUIRE(samePacked(game::pack(restored[index]), game::pack(events[index])));
+  }
+}
+
+TEST_CASE("Packed and variant events drive the game state alike", "[packed]")
+{
+  game::GameState fromVariant;
+  game::GameState fromPacked;
+  const game::EventList events{ game::Pressed<game::Key>{ false, false, false, false, sf::Keyboard::D },
+    game::Pressed<game::MouseButton>{ sf::Mouse::Right, { 0, 0 } },
+    game::TimeElapsed{ game::TickDuration } };
+  for (const auto &ev : events) {
+    fromVariant.processEvent(ev);
+    fromPacked.processEvent(game::pack(ev));
+  }
+  for (const auto action : { game::Action::MoveRight, game::Action::Cancel }) {
+    REQUIRE(fromVariant._input.actions.isDown(action) == fromPacked._input.actions.isDown(action));
+    REQUIRE(fromVariant._input.actions.wasPressed(action) == fromPacked._input.actions.wasPressed(action));
+  }
+}
+
+TEST_CASE("Packed event memory and dispatch throughput", "[.][benchmark]")
+{
+  constexpr std::size_t count = 1'000'000;
+  std::mt19937 random{ 1 };
+  std::uniform_int_distribution<int> kind{ 0, 3 };
+  game::EventList events;
+  events.reserve(count);
+  for (std::size_t index = 0; index < count; ++index) {
+    const auto value = static_cast<int>(index % 1000);
+    switch (kind(random)) {
+    case 0:
+      events.push_back(game::Pressed<game::Key>{ false, false, false, false, sf::Keyboard::W });
+      break;
+    case 1:
+      events.push_back(game::Released<game::Key>{ false, false, false, false, sf::Keyboard::W });
+      break;
+    case 2:
+      events.push_back(game::Moved<game::Mouse>{ value, value });
+      break;
+    default:
+      events.push_back(game::TimeElapsed{ std::chrono::milliseconds{ 16 } });
+      break;
+    }
+  }
+  const game::PackedEventList packed{ events };
+  WARN(fmt::format("{} events: EventList {} bytes ({} per event), PackedEventList {} bytes ({} per event)",
+    count,
+    events.capacity() * sizeof(game::Event),
+    sizeof(game::Event),
+    packed.memoryUsage(),
+    packed.memoryUsage() / count));
+
+  game::GameState gs;
+  BENCHMARK("GameState::processEvent over EventList")
+  {
+    for (const auto &ev : events) { gs.processEvent(ev); }
+    return gs._input.actions.isDown(game::Action::MoveUp);
+  };
+  BENCHMARK("GameState::processEvent over PackedEventList")
+  {
+    for (std::size_t index = 0; index < packed.size(); ++index) { gs.processEvent(packed[index]); }
+    return gs._input.actions.isDown(game::Action::MoveUp);
+  };
+}
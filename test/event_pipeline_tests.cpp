@@ -0,0 +1,179 @@
+#include <catch2/catch.hpp>
+#include <event_pipeline.h>
+#include <event_recorder.h>
+#include <fmt/format.h>
+#include <game_state.h>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+  constexpr game::Key key(const sf::Keyboard::Key code)
+  {
+    return game::Key{ false, false, false, false, code };
+  }
+
+  game::EventList session(const std::size_t ticks)
+  {
+    game::EventList events;
+    for (std::size_t tick = 0; tick < ticks; ++tick) {
+      const auto offset = static_cast<int>(tick % 100);
+      events.push_back(game::Moved<game::Mouse>{ offset, 0 });
+      events.push_back(game::Moved<game::Mouse>{ offset, 1 });
+      events.push_back(game::Moved<game::Mouse>{ offset, 2 });
+      if (tick % 2 == 0) {
+        events.push_back(game::Pressed<game::Key>{ key(sf::Keyboard::W) });
+      } else {
+        events.push_back(game::Released<game::Key>{ key(sf::Keyboard::W) });
+      }
+      events.push_back(game::Moved<game::JoystickAxis>{ 0, 0, static_cast<float>(offset) });
+      events.push_back(game::TimeElapsed{ std::chrono::milliseconds{ 16 } });
+    }
+    return events;
+  }
+
+  // One batch per event, what the old loop did
+  game::EventBatches singleEvents(game::EventList events)
+  {
+    for (auto &ev : events) {
+      game::EventList batch{ ev };
+      co_yield batch;
+    }
+  }
+
+  game::EventBatches failing(game::EventBatches upstream)
+  {
+    for (auto &batch : upstream) {
+      co_yield batch;
+      throw std::runtime_error{ "stage failed" };
+    }
+  }
+
+  std::vector<game::EventList> collect(game::EventBatches pipeline)
+  {
+    std::vector<game::EventList> result;
+    for (const auto &batch : pipeline) { result.push_back(batch); }
+    return result;
+  }
+}// namespace
+
+TEST_CASE("Batches end at TimeElapsed and CloseWindow", "[pipeline]")
+{
+  const auto result = collect(game::batches({ game::Pressed<game::Key>{ key(sf::Keyboard::A) },
+    game::TimeElapsed{},
+    game::TimeElapsed{},
+    game::Moved<game::Mouse>{ 1, 2 },
+    game::CloseWindow{},
+    game::Released<game::Key>{ key(sf::Keyboard::A) } }));
+
+  REQUIRE(result.size() == 4);
+  REQUIRE(result[0].size() == 2);
+  REQUIRE(result[1].size() == 1);
+  REQUIRE(result[2].size() == 2);
+  REQUIRE(std::holds_alternative<game::CloseWindow>(result[2].back()));
+  REQUIRE(result[3].size() == 1);
+}
+
+TEST_CASE("Filter and coalesce rewrite batches in place", "[pipeline]")
+{
+  const auto result = collect(game::batches({ game::Moved<game::Mouse>{ 1, 1 },
+                                game::Moved<game::Mouse>{ 2, 2 },
+                                std::monostate{},
+                                game::Moved<game::Mouse>{ 3, 3 },
+                                game::Pressed<game::Key>{ key(sf::Keyboard::A) },
+                                game::Moved<game::Mouse>{ 4, 4 },
+                                game::Moved<game::JoystickAxis>{ 0, 0, 10.f },
+                                game::Moved<game::JoystickAxis>{ 0, 0, 90.f },
+                                game::TimeElapsed{} })
+                              | game::filter([](const game::Event &ev) { return !std::holds_alternative<std::monostate>(ev); })
+                              | game::coalesce());
+
+  REQUIRE(result.size() == 1);
+  const auto &batch = result.front();
+  REQUIRE(batch.size() == 6);
+  REQUIRE(std::get<game::Moved<game::Mouse>>(batch[0]).source.x == 3);
+  REQUIRE(std::holds_alternative<game::Pressed<game::Key>>(batch[1]));
+  REQUIRE(std::get<game::Moved<game::Mouse>>(batch[2]).source.x == 4);
+  REQUIRE(std::get<game::Moved<game::JoystickAxis>>(batch[3]).source.position == 10.f);
+  REQUIRE(std::get<game::Moved<game::JoystickAxis>>(batch[4]).source.position == 90.f);
+}
+
+TEST_CASE("Simulating and recording in the pipeline matches the per event loop", "[pipeline]")
+{
+  const auto events = session(200);
+
+  game::GameState expectedState;
+  game::EventRecorder expectedRecorder{ 10 };
+  for (const auto &ev : events) {
+    expectedRecorder.processEvent(ev);
+    expectedState.processEvent(ev);
+    if (std::holds_alternative<game::TimeElapsed>(ev)) { expectedRecorder.checkpoint(expectedState.hash()); }
+  }
+
+  game::GameState gs;
+  game::EventRecorder recorder{ 10 };
+  std::size_t observed = 0;
+  for ([[maybe_unused]] const auto &batch :
+    game::batches(events) | game::simulate(gs, [&](const game::Event &) { ++observed; }) | game::record(recorder, gs)) {}
+
+  REQUIRE(observed == events.size());
+  REQUIRE(gs.hash() == expectedState.hash());
+  REQUIRE(recorder.events().size() == expectedRecorder.events().size());
+  for (std::size_t index = 0; index < recorder.events().size(); ++index) {
+    REQUIRE(recorder.events()[index].index() == expectedRecorder.events()[index].index());
+  }
+}
+
+TEST_CASE("Offloaded consumers see every batch in order on another thread", "[pipeline]")
+{
+  std::vector<std::size_t> sizes;
+  std::thread::id consumerThread;
+  std::size_t batchCount = 0;
+  {
+    auto pipeline = game::batches(session(50)) | game::offload([&](const game::EventList &batch) {
+      sizes.push_back(batch.size());
+      consumerThread = std::this_thread::get_id();
+    });
+    for ([[maybe_unused]] const auto &batch : pipeline) { ++batchCount; }
+  }
+
+  REQUIRE(batchCount == 50);
+  REQUIRE(sizes == std::vector<std::size_t>(50, 6));
+  REQUIRE(consumerThread != std::this_thread::get_id());
+}
+
+TEST_CASE("Exceptions thrown in a stage reach the consumer", "[pipeline]")
+{
+  auto pipeline = game::batches(session(3)) | failing;
+  auto batch = pipeline.begin();
+  REQUIRE_THROWS_AS(++batch, std::runtime_error);
+}
+
+TEST_CASE("Per event and batched pipeline throughput", "[.][benchmark]")
+{
+  const auto events = session(10'000);
+  const auto filterEmpty = [](const game::Event &ev) { return !std::holds_alternative<std::monostate>(ev); };
+  WARN(fmt::format("{} events in {} ticks", events.size(), 10'000));
+
+  BENCHMARK("plain loop")
+  {
+    game::GameState gs;
+    for (const auto &ev : events) {
+      if (filterEmpty(ev)) { gs.processEvent(ev); }
+    }
+    return gs.hash();
+  };
+
+  BENCHMARK("pipeline, one batch per event")
+  {
+    game::GameState gs;
+    for ([[maybe_unused]] const auto &batch : singleEvents(events) | game::filter(filterEmpty) | game::coalesce() | game::simulate(gs)) {}
+    return gs.hash();
+  };
+
+  BENCHMARK("pipeline, one batch per tick")
+  {
+    game::GameState gs;
+    for ([[maybe_unused]] const auto &batch : game::batches(events) | game::filter(filterEmpty) | game::coalesce() | game::simulate(gs)) {}
+    return gs.hash();
+  };
+}
@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fmt/format.h>
+#include <font_atlas_cache.h>
+#include <imgui.h>
+#include <random>
+
+namespace {
+  // Named after the test case plus a random suffix, ctest runs test cases and possibly several builds in parallel
+  std::filesystem::path uniqueDirectory()
+  {
+    auto name = Catch::getResultCapture().getCurrentTestName();
+    std::replace_if(
+      name.begin(), name.end(), [](const unsigned char c) { return std::isalnum(c) == 0; }, '_');
+    std::random_device random;
+    const auto suffix = (std::uint64_t{ random() } << 32U) | random();
+    return std::filesystem::temp_directory_path() / fmt::format("game_font_atlas_cache_{}_{:016x}", name, suffix);
+  }
+
+  struct TemporaryDirectory
+  {
+    const std::filesystem::path path = uniqueDirectory();
+
+    TemporaryDirectory() = default;
+    TemporaryDirectory(const TemporaryDirectory &) = delete;
+    TemporaryDirectory &operator=(const TemporaryDirectory &) = delete;
+    ~TemporaryDirectory() { std::filesystem::remove_all(path); }
+  };
+}// namespace
+
+TEST_CASE("Font atlases are restored from the cache", "[fonts]")
+{
+  const TemporaryDirectory directory;
+  game::FontAtlasCache coldCache{ directory.path };
+  ImFontAtlas rasterized;
+  REQUIRE_FALSE(coldCache.load(rasterized, 2.f));
+
+  game::FontAtlasCache warmCache{ directory.path };
+  ImFontAtlas cached;
+  REQUIRE(warmCache.load(cached, 2.f));
+
+  REQUIRE(cached.TexWidth == rasterized.TexWidth);
+  REQUIRE(cached.TexHeight == rasterized.TexHeight);
+  REQUIRE(cached.Fonts.Size == 1);
+  REQUIRE(cached.Fonts[0]->FontSize == rasterized.Fonts[0]->FontSize);
+  REQUIRE(cached.Fonts[0]->Glyphs.Size == rasterized.Fonts[0]->Glyphs.Size);
+  REQUIRE(cached.Fonts[0]->FindGlyph('A')->AdvanceX == rasterized.Fonts[0]->FindGlyph('A')->AdvanceX);
+  const auto pixelBytes = static_cast<std::size_t>(cached.TexWidth) * static_cast<std::size_t>(cached.TexHeight) * 4;
+  REQUIRE(std::memcmp(cached.TexPixelsRGBA32, rasterized.TexPixelsRGBA32, pixelBytes) == 0);
+
+  warmCache.release(cached);
+  REQUIRE(cached.TexPixelsRGBA32 == nullptr);
+}
+
+TEST_CASE("Every UI scale gets its own atlas", "[fonts]")
+{
+  const TemporaryDirectory directory;
+  game::FontAtlasCache cache{ directory.path };
+  ImFontAtlas first;
+  REQUIRE_FALSE(cache.load(first, 1.f));
+  ImFontAtlas second;
+  REQUIRE_FALSE(cache.load(second, 3.f));
+  REQUIRE(second.Fonts[0]->FontSize > first.Fonts[0]->FontSize);
+}
+
+TEST_CASE("Font atlas startup with cold and warm cache", "[.][benchmark]")
+{
+  const TemporaryDirectory directory;
+  for (const auto scale : { 1.f, 3.f, 5.f }) {
+    const auto measure = [&](ImFontAtlas &atlas, game::FontAtlasCache &cache) {
+      const auto start = std::chrono::steady_clock::now();
+      cache.load(atlas, scale);
+      return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+    game::FontAtlasCache cache{ directory.path };
+    ImFontAtlas cold;
+    const auto coldTime = measure(cold, cache);
+    ImFontAtlas warm;
+    const auto warmTime = measure(warm, cache);
+    cache.release(warm);
+    WARN(fmt::format("scale {}: cold {} us, warm {} us", scale, coldTime, warmTime));
+  }
+}
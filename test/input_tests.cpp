@@ -0,0 +1,172 @@
+#include <catch2/catch.hpp>
+#include <game_state.h>
+
+namespace {
+  constexpr game::Key key(const sf::Keyboard::Key code)
+  {
+    return game::Key{ false, false, false, false, code };
+  }
+}// namespace
+
+TEST_CASE("Action edges are visible for exactly one tick", "[input]")
+{
+  game::GameState gs;
+  gs.processEvent(game::Pressed<game::Key>{ key(sf::Keyboard::W) });
+  REQUIRE(gs._input.actions.isDown(game::Action::MoveUp));
+  REQUIRE_FALSE(gs._input.actions.wasPressed(game::Action::MoveUp));
+
+  gs.processEvent(game::TimeElapsed{ game::TickDuration });
+  REQUIRE(gs._input.actions.wasPressed(game::Action::MoveUp));
+
+  gs.processEvent(game::TimeElapsed{ game::TickDuration });
+  REQUIRE_FALSE(gs._input.actions.wasPressed(game::Action::MoveUp));
+  REQUIRE(gs._input.actions.isDown(game::Action::MoveUp));
+
+  gs.processEvent(game::Released<game::Key>{ key(sf::Keyboard::W) });
+  gs.processEvent(game::TimeElapsed{ game::TickDuration });
+  REQUIRE(gs._input.actions.wasReleased(game::Action::MoveUp));
+  REQUIRE_FALSE(gs._input.actions.isDown(game::Action::MoveUp));
+}
+
+TEST_CASE("A tap between two ticks reports both edges", "[input]")
+{
+  game::GameState gs;
+  gs.processEvent(game::Pressed<game::MouseButton>{ sf::Mouse::Left, { 0, 0 } });
+  gs.processEvent(game::Released<game::MouseButton>{ sf::Mouse::Left, { 0, 0 } });
+  gs.processEvent(game::TimeElapsed{ game::TickDuration });
+  REQUIRE(gs._input.actions.wasPressed(game::Action::Confirm));
+  REQUIRE(gs._input.actions.wasReleased(game::Action::Confirm));
+  REQUIRE_FALSE(gs._input.actions.isDown(game::Action::Confirm));
+}
+
+TEST_CASE("Rebinding takes effect on the next event", "[input]")
+{
+  game::GameState gs;
+  gs._input.bind(sf::Keyboard::Q, game::Action::Cancel);
+  gs.processEvent(game::Pressed<game::Key>{ key(sf::Keyboard::Q) });
+  REQUIRE(gs._input.actions.isDown(game::Action::Cancel));
+}
+
+TEST_CASE("Rebinding a held input moves it to the new action", "[input]")
+{
+  game::GameState gs;
+  gs.processEvent(game::Connected<game::JoystickDevice>{ { 0, 8 } });
+  gs.processEvent(game::Connected<game::JoystickDevice>{ { 1, 8 } });
+  gs.processEvent(game::Pressed<game::Key>{ key(sf::Keyboard::W) });
+  gs.processEvent(game::Pressed<game::JoystickButton>{ 0, 0 });
+  gs.processEvent(game::Pressed<game::JoystickButton>{ 1, 0 });
+  gs.processEvent(game::Moved<game::JoystickAxis>{ 0, sf::Joystick::X, 80.f });
+
+  gs._input.bind(sf::Keyboard::W, game::Action::Menu);
+  gs._input.bindJoystickButton(0, game::Action::Cancel);
+  gs._input.bind(sf::Joystick::X, game::AxisBinding{ game::Action::MoveUp, game::Action::MoveDown, 90.f });
+  REQUIRE_FALSE(gs._input.actions.isDown(game::Action::MoveUp));
+  REQUIRE_FALSE(gs._input.actions.isDown(game::Action::Confirm));
+  REQUIRE_FALSE(gs._input.actions.isDown(game::Action::MoveRight));
+  REQUIRE_FALSE(gs._input.actions.isDown(game::Action::MoveDown));
+  REQUIRE(gs._input.actions.isDown(game::Action::Menu));
+  REQUIRE(gs._input.actions.isDown(game::Action::Cancel));
+  REQUIRE(gs._input.hash.value() == gs._input.computeHash());
+
+  gs.processEvent(game::Moved<game::JoystickAxis>{ 0, sf::Joystick::X, 95.f });
+  REQUIRE(gs._input.actions.isDown(game::Action::MoveDown));
+  gs.processEvent(game::Released<game::Key>{ key(sf::Keyboard::W) });
+  gs.processEvent(game::Released<game::JoystickButton>{ 0, 0 });
+  REQUIRE(gs._input.actions.isDown(game::Action::Cancel));
+  gs.processEvent(game::Released<game::JoystickButton>{ 1, 0 });
+  gs.processEvent(game::Moved<game::JoystickAxis>{ 0, sf::Joystick::X, 0.f });
+  for (std::size_t index = 1; index < game::ActionCount; ++index) {
+    REQUIRE_FALSE(gs._input.actions.isDown(static_cast<game::Action>(index)));
+  }
+  REQUIRE(gs._input.hash.value() == gs._input.computeHash());
+}
+
+TEST_CASE("Unbound and unknown keys do not trigger actions", "[input]")
+{
+  game::GameState gs;
+  gs.processEvent(game::Pressed<game::Key>{ key(sf::Keyboard::Unknown) });
+  gs.processEvent(game::Pressed<game::Key>{ key(sf::Keyboard::Z) });
+  gs.processEvent(game::TimeElapsed{ game::TickDuration });
+  for (std::size_t index = 1; index < game::ActionCount; ++index) {
+    REQUIRE_FALSE(gs._input.actions.isDown(static_cast<game::Action>(index)));
+  }
+}
+
+TEST_CASE("An action stays down while any of its inputs is held", "[input]")
+{
+  game::GameState gs;
+  gs.processEvent(game::Pressed<game::Key>{ key(sf::Keyboard::W) });
+  gs.processEvent(game::Pressed<game::Key>{ key(sf::Keyboard::Up) });
+  gs.processEvent(game::Released<game::Key>{ key(sf::Keyboard::W) });
+  gs.processEvent(game::TimeElapsed{ game::TickDuration });
+  REQUIRE(gs._input.actions.isDown(game::Action::MoveUp));
+  REQUIRE_FALSE(gs._input.actions.wasReleased(game::Action::MoveUp));
+
+  gs.processEvent(game::Released<game::Key>{ key(sf::Keyboard::Up) });
+  gs.processEvent(game::TimeElapsed{ game::TickDuration });
+  REQUIRE(gs._input.actions.wasReleased(game::Action::MoveUp));
+  REQUIRE_FALSE(gs._input.actions.isDown(game::Action::MoveUp));
+}
+
+TEST_CASE("Repeated presses of a held input are not extra holders", "[input]")
+{
+  game::GameState gs;
+  gs.processEvent(game::Pressed<game::Key>{ key(sf::Keyboard::Space) });
+  gs.processEvent(game::Pressed<game::Key>{ key(sf::Keyboard::Space) });
+  gs.processEvent(game::Released<game::Key>{ key(sf::Keyboard::Space) });
+  REQUIRE_FALSE(gs._input.actions.isDown(game::Action::Confirm));
+}
+
+TEST_CASE("Axis noise does not release actions held by other inputs", "[input]")
+{
+  game::GameState gs;
+  gs.processEvent(game::Connected<game::JoystickDevice>{ { 0, 8 } });
+  gs.processEvent(game::Pressed<game::Key>{ key(sf::Keyboard::A) });
+  gs.processEvent(game::TimeElapsed{ game::TickDuration });
+
+  for (const auto position : { 3.f, -7.f, 0.5f, 0.f }) {
+    gs.processEvent(game::Moved<game::JoystickAxis>{ 0, sf::Joystick::X, position });
+  }
+  gs.processEvent(game::TimeElapsed{ game::TickDuration });
+  REQUIRE(gs._input.actions.isDown(game::Action::MoveLeft));
+  REQUIRE_FALSE(gs._input.actions.wasReleased(game::Action::MoveLeft));
+  REQUIRE_FALSE(gs._input.actions.isDown(game::Action::MoveRight));
+
+  SECTION("The stick holds the action until it crosses back")
+  {
+    gs.processEvent(game::Moved<game::JoystickAxis>{ 0, sf::Joystick::X, -80.f });
+    gs.processEvent(game::Released<game::Key>{ key(sf::Keyboard::A) });
+    gs.processEvent(game::Moved<game::JoystickAxis>{ 0, sf::Joystick::X, -60.f });
+    REQUIRE(gs._input.actions.isDown(game::Action::MoveLeft));
+
+    gs.processEvent(game::Moved<game::JoystickAxis>{ 0, sf::Joystick::X, -10.f });
+    REQUIRE_FALSE(gs._input.actions.isDown(game::Action::MoveLeft));
+  }
+}
+
+TEST_CASE("Joysticks only count between connect and disconnect", "[input]")
+{
+  game::GameState gs;
+  gs.processEvent(game::Pressed<game::JoystickButton>{ 5, 0 });
+  gs.processEvent(game::Moved<game::JoystickAxis>{ 5, sf::Joystick::X, -80.f });
+  REQUIRE(gs._input.joysticks.empty());
+  REQUIRE_FALSE(gs._input.actions.isDown(game::Action::Confirm));
+  REQUIRE_FALSE(gs._input.actions.isDown(game::Action::MoveLeft));
+
+  gs.processEvent(game::Connected<game::JoystickDevice>{ { 5, 2 } });
+  gs.processEvent(game::Pressed<game::JoystickButton>{ 5, 2 });
+  REQUIRE_FALSE(gs._input.joysticks.find(5)->buttonState[2]);
+
+  gs.processEvent(game::Pressed<game::JoystickButton>{ 5, 0 });
+  gs.processEvent(game::Moved<game::JoystickAxis>{ 5, sf::Joystick::X, -80.f });
+  REQUIRE(gs._input.actions.isDown(game::Action::Confirm));
+  REQUIRE(gs._input.actions.isDown(game::Action::MoveLeft));
+
+  gs.processEvent(game::Disconnected<game::JoystickDevice>{ { 5, 0 } });
+  REQUIRE_FALSE(gs._input.actions.isDown(game::Action::Confirm));
+  REQUIRE_FALSE(gs._input.actions.isDown(game::Action::MoveLeft));
+  REQUIRE_FALSE(gs._input.joysticks.find(5)->connected);
+
+  gs.processEvent(game::Pressed<game::JoystickButton>{ 5, 0 });
+  REQUIRE_FALSE(gs._input.actions.isDown(game::Action::Confirm));
+}
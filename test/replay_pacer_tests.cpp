@@ -0,0 +1,108 @@
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <fmt/format.h>
+#include <replay_pacer.h>
+#include <thread>
+
+namespace {
+  using namespace std::chrono_literals;
+
+  std::chrono::microseconds micros(const game::Clock::duration duration)
+  {
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration);
+  }
+}// namespace
+
+TEST_CASE("Replay speed is clamped to the supported range", "[replay]")
+{
+  game::ReplayPacer pacer{ 100.0 };
+  REQUIRE(pacer.speed() == game::ReplayPacer::MaxSpeed);
+  pacer.setSpeed(0.01);
+  REQUIRE(pacer.speed() == game::ReplayPacer::MinSpeed);
+  pacer.setSpeed(2.0);
+  REQUIRE(pacer.speed() == 2.0);
+}
+
+TEST_CASE("Paused replays advance one step at a time", "[replay]")
+{
+  game::ReplayPacer pacer{ 1.0, false, true };
+  REQUIRE_FALSE(pacer.ready());
+
+  pacer.step();
+  REQUIRE(pacer.ready());
+  const auto start = game::Clock::now();
+  pacer.wait(1s);
+  REQUIRE(game::Clock::now() - start < 500ms);
+  REQUIRE_FALSE(pacer.ready());
+
+  pacer.setPaused(false);
+  REQUIRE(pacer.ready());
+}
+
+TEST_CASE("Deadlines are absolute so oversleeping does not add up", "[replay]")
+{
+  const auto speed = GENERATE(1.0, 4.0);
+  game::ReplayPacer pacer{ speed };
+  constexpr int ticks = 40;
+  constexpr auto tick = 4ms;
+
+  const auto start = game::Clock::now();
+  for (int index = 0; index < ticks; ++index) {
+    pacer.wait(tick);
+    // work done between ticks is absorbed by the next deadline
+    if (index % 10 == 0) { std::this_thread::sleep_for(tick / speed / 2); }
+  }
+  const auto elapsed = game::Clock::now() - start;
+  const auto expected = std::chrono::duration_cast<game::Clock::duration>(tick * ticks / speed);
+
+  REQUIRE(elapsed >= expected);
+  REQUIRE(elapsed < expected + 20ms);
+  REQUIRE(pacer.stats().ticks == ticks);
+}
+
+TEST_CASE("Unthrottled replays do not wait", "[replay]")
+{
+  game::ReplayPacer pacer{ 1.0, true };
+  const auto start = game::Clock::now();
+  for (int index = 0; index < 1000; ++index) { pacer.wait(1s); }
+  REQUIRE(game::Clock::now() - start < 1s);
+  REQUIRE(pacer.stats().ticks == 0);
+}
+
+TEST_CASE("Falling far behind restarts the time base", "[replay]")
+{
+  game::ReplayPacer pacer;
+  pacer.wait(1ms);
+  std::this_thread::sleep_for(game::ReplayPacer::MaxLag + 50ms);
+
+  // without the restart these would all be overdue and released at once
+  const auto start = game::Clock::now();
+  pacer.wait(1ms);
+  pacer.wait(10ms);
+  REQUIRE(game::Clock::now() - start >= 10ms);
+}
+
+TEST_CASE("Replay pacing error", "[.][benchmark]")
+{
+  constexpr int ticks = 120;
+  constexpr auto tick = std::chrono::duration_cast<game::Clock::duration>(std::chrono::nanoseconds{ 1'000'000'000 / 60 });
+
+  // what the old commented out replay did
+  game::Clock::duration naiveDrift{};
+  {
+    const auto start = game::Clock::now();
+    for (int index = 0; index < ticks; ++index) { std::this_thread::sleep_for(tick); }
+    naiveDrift = game::Clock::now() - start - tick * ticks;
+  }
+
+  game::ReplayPacer pacer;
+  const auto start = game::Clock::now();
+  for (int index = 0; index < ticks; ++index) { pacer.wait(tick); }
+  const auto drift = game::Clock::now() - start - tick * ticks;
+
+  WARN(fmt::format("sleep_for per tick: {} us drift after {} ticks", micros(naiveDrift).count(), ticks));
+  WARN(fmt::format("paced: {} us drift, error mean {} us, max {} us",
+    micros(drift).count(),
+    micros(pacer.stats().meanError()).count(),
+    micros(pacer.stats().maxError).count()));
+}
@@ -0,0 +1,152 @@
+#include <catch2/catch.hpp>
+#include <components.h>
+#include <fmt/format.h>
+#include <game_state.h>
+#include <random>
+#include <rollback_session.h>
+
+namespace {
+  // Order sensitive checksum of everything a player has seen
+  struct Tally
+  {
+    std::uint64_t value = 0;
+
+    void processEvent(const game::Event &ev) { value = value * 31 + ev.index() + 1; }
+
+    bool operator==(const Tally &) const = default;
+  };
+
+  game::EventList randomInput(std::mt19937 &random)
+  {
+    const auto key = static_cast<sf::Keyboard::Key>(std::uniform_int_distribution<int>{ sf::Keyboard::A, sf::Keyboard::Z }(random));
+    switch (std::uniform_int_distribution<int>{ 0, 3 }(random)) {
+    case 0:
+      return { game::Pressed<game::Key>{ false, false, false, false, key } };
+    case 1:
+      return { game::Released<game::Key>{ false, false, false, false, key } };
+    default:
+      return {};
+    }
+  }
+
+  template<typename Session>
+  void play(game::LoopbackNetwork &network, Session &first, Session &second, std::uint32_t ticks)
+  {
+    std::mt19937 random{ 42 };
+    while (first.tick() < ticks || second.tick() < ticks) {
+      network.tick();
+      for (auto *session : { &first, &second }) {
+        if (session->tick() < ticks) {
+          session->advance(randomInput(random));
+        } else {
+          session->poll();
+        }
+      }
+    }
+    while (first.confirmedTick() < ticks || second.confirmedTick() < ticks) {
+      network.tick();
+      first.poll();
+      second.poll();
+    }
+  }
+}// namespace
+
+TEST_CASE("Input packets survive encoding", "[rollback]")
+{
+  const game::InputPacket packet{ 3, 2, { {}, { game::Pressed<game::Key>{ false, true, false, false, sf::Keyboard::Q } } } };
+  const auto decoded = game::decode(game::encode(packet));
+  REQUIRE(decoded);
+  REQUIRE(decoded->firstTick == 3);
+  REQUIRE(decoded->ack == 2);
+  REQUIRE(decoded->inputs.size() == 2);
+  REQUIRE(decoded->inputs[0].empty());
+  REQUIRE(std::holds_alternative<game::Pressed<game::Key>>(decoded->inputs[1].at(0)));
+}
+
+TEST_CASE("Malformed packets are dropped", "[rollback]")
+{
+  REQUIRE_FALSE(game::decode(game::Packet{ 0xc1, 0x00, 0xff }));
+}
+
+TEST_CASE("Peers without latency roll back at most one tick", "[rollback]")
+{
+  game::LoopbackNetwork network{ {} };
+  game::RollbackSession<Tally> first{ 0, network.endpoint(0) };
+  game::RollbackSession<Tally> second{ 1, network.endpoint(1) };
+  play(network, first, second, 120);
+
+  REQUIRE(first.states() == second.states());
+  REQUIRE(first.stats().maxDepth <= 1);
+  REQUIRE(second.stats().maxDepth <= 1);
+}
+
+TEST_CASE("Peers converge under latency and packet loss", "[rollback]")
+{
+  const auto config = GENERATE(game::LoopbackConfig{ 2, 0, 0.0, 1 },
+    game::LoopbackConfig{ 4, 2, 0.1, 2 },
+    game::LoopbackConfig{ 6, 3, 0.3, 3 });
+  game::LoopbackNetwork network{ config };
+  game::RollbackSession<Tally> first{ 0, network.endpoint(0) };
+  game::RollbackSession<Tally> second{ 1, network.endpoint(1) };
+  play(network, first, second, 300);
+
+  REQUIRE(first.states() == second.states());
+  REQUIRE(first.stats().rollbacks > 0);
+  REQUIRE(first.stats().maxDepth <= 8);
+}
+
+TEST_CASE("Restoring a game state snapshot undoes the simulation", "[rollback]")
+{
+  game::GameState gs;
+  const auto crate = gs._world.create(game::Position{ 200.f, 100.f }, game::Shape{ 10.f, 10.f });
+  gs.processEvent(game::Pressed<game::Key>{ false, false, false, false, sf::Keyboard::D });
+  gs.processEvent(game::TimeElapsed{ game::TickDuration });
+
+  game::GameState::Snapshot snapshot;
+  gs.save(snapshot);
+  const auto saved = gs.hash();
+
+  gs._world.destroy(crate);
+  gs.processEvent(game::Moved<game::Mouse>{ 5, 5 });
+  gs.processEvent(game::TimeElapsed{ game::TickDuration * 30 });
+  REQUIRE(gs.hash() != saved);
+
+  gs.restore(snapshot);
+  REQUIRE(gs.hash() == saved);
+  REQUIRE(gs.worldHash() == gs.computeWorldHash());
+  REQUIRE(gs._spatial.contains(crate));
+  gs.processEvent(game::Moved<game::Mouse>{ 200, 100 });
+  REQUIRE(gs._hovered == crate);
+}
+
+TEST_CASE("Rollback cost per tick at 60 Hz", "[.][benchmark]")
+{
+  game::LoopbackNetwork network{ { 6, 2, 0.05, 7 } };
+  game::RollbackSession<game::GameState> first{ 0, network.endpoint(0), 16 };
+  game::RollbackSession<game::GameState> second{ 1, network.endpoint(1), 16 };
+  play(network, first, second, 600);
+
+  const auto &stats = first.stats();
+  REQUIRE(stats.resimulatedTicks > 0);
+  const auto costPerTick = stats.rollbackTime / static_cast<game::Clock::rep>(stats.resimulatedTicks);
+  const auto sustainableDepth = game::TickDuration / std::max(costPerTick, game::Clock::duration{ 1 });
+  WARN(fmt::format("{} rollbacks, max depth {}, {} ns per re-simulated tick, sustainable depth at 60 Hz {}",
+    stats.rollbacks,
+    stats.maxDepth,
+    std::chrono::nanoseconds{ costPerTick }.count(),
+    sustainableDepth));
+
+  auto states = first.states();
+  std::array<game::GameState::Snapshot, 2> snapshots;
+  const game::EventList input{ game::Pressed<game::Key>{ false, false, false, false, sf::Keyboard::W } };
+  BENCHMARK("Snapshot, simulate and restore one tick")
+  {
+    for (std::size_t player = 0; player < states.size(); ++player) {
+      states[player].save(snapshots[player]);
+      for (const auto &ev : input) { states[player].processEvent(ev); }
+      states[player].processEvent(game::TimeElapsed{ game::TickDuration });
+      states[player].restore(snapshots[player]);
+    }
+    return states[0].hash();
+  };
+}
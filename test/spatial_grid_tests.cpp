@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <components.h>
+#include <fmt/format.h>
+#include <game_state.h>
+#include <limits>
+#include <random>
+#include <spatial_grid.h>
+
+namespace {
+  game::Entity entity(const std::uint32_t index)
+  {
+    return game::Entity{ index, 0 };
+  }
+
+  game::Bounds box(const float x, const float y, const float halfSize)
+  {
+    return game::Bounds{ x - halfSize, y - halfSize, x + halfSize, y + halfSize };
+  }
+
+  template<typename Query>
+  std::vector<std::uint32_t> collect(Query &&query)
+  {
+    std::vector<std::uint32_t> result;
+    query([&](const game::Entity found) { result.push_back(found.index); });
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+  struct Scene
+  {
+    std::vector<game::Bounds> bounds;
+    game::SpatialGrid grid{ 32.f };
+
+    Scene(const std::size_t count, const float extent, const unsigned int seed)
+    {
+      std::mt19937 rng{ seed };
+      std::uniform_real_distribution<float> position{ 0.f, extent };
+      std::uniform_real_distribution<float> size{ 1.f, 12.f };
+      for (std::uint32_t index = 0; index < count; ++index) {
+        bounds.push_back(box(position(rng), position(rng), size(rng)));
+        grid.update(entity(index), bounds.back());
+      }
+    }
+
+    template<typename Predicate>
+    std::vector<std::uint32_t> bruteForce(Predicate &&predicate) const
+    {
+      std::vector<std::uint32_t> result;
+      for (std::uint32_t index = 0; index < bounds.size(); ++index) {
+        if (predicate(bounds[index])) { result.push_back(index); }
+      }
+      return result;
+    }
+  };
+}// namespace
+
+TEST_CASE("Grid queries agree with a linear scan", "[spatial]")
+{
+  Scene scene{ 2000, 1000.f, 1 };
+  const auto [x, y] = GENERATE(std::pair{ 500.f, 500.f }, std::pair{ 0.f, 0.f }, std::pair{ 31.9f, 64.f }, std::pair{ -50.f, 20.f });
+
+  REQUIRE(collect([&](auto f) { scene.grid.queryPoint(x, y, f); })
+          == scene.bruteForce([&](const game::Bounds &bounds) { return bounds.contains(x, y); }));
+
+  const auto area = game::Bounds{ x - 70.f, y - 30.f, x + 90.f, y + 10.f };
+  REQUIRE(collect([&](auto f) { scene.grid.queryRect(area, f); })
+          == scene.bruteForce([&](const game::Bounds &bounds) { return bounds.intersects(area); }));
+
+  REQUIRE(collect([&](auto f) { scene.grid.queryRadius(x, y, 45.f, f); })
+          == scene.bruteForce([&](const game::Bounds &bounds) { return bounds.distanceSquared(x, y) <= 45.f * 45.f; }));
+
+  // larger than the occupied area, takes the path over occupied cells
+  const auto everything = game::Bounds{ -1e6f, -1e6f, 1e6f, 1e6f };
+  REQUIRE(collect([&](auto f) { scene.grid.queryRect(everything, f); }).size() == 2000);
+}
+
+TEST_CASE("Moving and removing objects keeps the grid consistent", "[spatial]")
+{
+  Scene scene{ 500, 400.f, 2 };
+  std::mt19937 rng{ 3 };
+  std::uniform_real_distribution<float> step{ -20.f, 20.f };
+  for (int round = 0; round < 20; ++round) {
+    for (std::uint32_t index = 0; index < scene.bounds.size(); ++index) {
+      auto &bounds = scene.bounds[index];
+      const auto dx = step(rng);
+      const auto dy = step(rng);
+      bounds = game::Bounds{ bounds.minX + dx, bounds.minY + dy, bounds.maxX + dx, bounds.maxY + dy };
+      scene.grid.update(entity(index), bounds);
+    }
+  }
+
+  for (std::uint32_t index = 0; index < scene.bounds.size(); index += 2) {
+    scene.grid.remove(entity(index));
+    scene.bounds[index] = game::Bounds{ 1e9f, 1e9f, 1e9f, 1e9f };
+  }
+  REQUIRE(scene.grid.size() == 250);
+  REQUIRE_FALSE(scene.grid.contains(entity(0)));
+  REQUIRE(scene.grid.contains(entity(1)));
+
+  const auto area = game::Bounds{ -100.f, -100.f, 500.f, 500.f };
+  REQUIRE(collect([&](auto f) { scene.grid.queryRect(area, f); })
+          == scene.bruteForce([&](const game::Bounds &bounds) { return bounds.intersects(area); }));
+}
+
+TEST_CASE("Huge and non-finite bounds do not break the grid", "[spatial]")
+{
+  game::SpatialGrid grid{ 32.f };
+  const auto huge = game::Bounds{ -3e38f, -3e38f, 3e38f, 3e38f };
+  grid.update(entity(0), huge);
+  grid.update(entity(1), box(10.f, 10.f, 4.f));
+  REQUIRE(grid.cellCount() == 1);
+  REQUIRE(collect([&](auto f) { grid.queryPoint(1e30f, -1e30f, f); }) == std::vector<std::uint32_t>{ 0 });
+  REQUIRE(collect([&](auto f) { grid.queryPoint(10.f, 10.f, f); }) == std::vector<std::uint32_t>{ 0, 1 });
+  REQUIRE(collect([&](auto f) { grid.queryRadius(500.f, 500.f, 5.f, f); }) == std::vector<std::uint32_t>{ 0 });
+  REQUIRE(collect([&](auto f) { grid.queryRect(huge, f); }) == std::vector<std::uint32_t>{ 0, 1 });
+
+  // shrinking back below the limit lists it in cells again
+  grid.update(entity(0), box(500.f, 500.f, 4.f));
+  REQUIRE(collect([&](auto f) { grid.queryPoint(1e30f, -1e30f, f); }).empty());
+  REQUIRE(collect([&](auto f) { grid.queryRadius(500.f, 500.f, 5.f, f); }) == std::vector<std::uint32_t>{ 0 });
+
+  const auto nan = std::numeric_limits<float>::quiet_NaN();
+  grid.update(entity(1), game::Bounds{ nan, 0.f, 1.f, 1.f });
+  grid.update(entity(2), game::Bounds{ 0.f, 0.f, std::numeric_limits<float>::infinity(), 1.f });
+  REQUIRE_FALSE(grid.contains(entity(1)));
+  REQUIRE_FALSE(grid.contains(entity(2)));
+  REQUIRE(grid.size() == 1);
+  REQUIRE(collect([&](auto f) { grid.queryPoint(nan, nan, f); }).empty());
+}
+
+TEST_CASE("Mouse hover and click pick entities", "[spatial]")
+{
+  game::GameState gs;
+  const auto crate = gs._world.create(game::Position{ 200.f, 100.f }, game::Shape{ 10.f, 10.f });
+  gs.processEvent(game::TimeElapsed{ game::TickDuration });
+
+  gs.processEvent(game::Moved<game::Mouse>{ 205, 95 });
+  REQUIRE(gs._hovered == crate);
+  gs.processEvent(game::Moved<game::Mouse>{ 5, -5 });
+  REQUIRE(gs._hovered == gs._player);
+  gs.processEvent(game::Moved<game::Mouse>{ 300, 300 });
+  REQUIRE_FALSE(gs._hovered);
+
+  gs.processEvent(game::Pressed<game::MouseButton>{ sf::Mouse::Left, { 195, 105 } });
+  REQUIRE(gs._selected == crate);
+  gs.processEvent(game::Pressed<game::MouseButton>{ sf::Mouse::Right, { 0, 0 } });
+  REQUIRE(gs._selected == crate);
+  gs.processEvent(game::Pressed<game::MouseButton>{ sf::Mouse::Left, { 300, 300 } });
+  REQUIRE_FALSE(gs._selected);
+
+  // the index follows movement on the next tick
+  gs.processEvent(game::Pressed<game::Key>{ false, false, false, false, sf::Keyboard::D });
+  gs.processEvent(game::TimeElapsed{ game::TickDuration });
+  gs.processEvent(game::TimeElapsed{ std::chrono::seconds{ 1 } });
+  gs.processEvent(game::Moved<game::Mouse>{ 200, 0 });
+  REQUIRE(gs._hovered == gs._player);
+}
+
+TEST_CASE("The index follows destroyed entities and lost shapes", "[spatial]")
+{
+  game::GameState gs;
+  const auto crate = gs._world.create(game::Position{ 200.f, 100.f }, game::Shape{ 10.f, 10.f });
+  const auto barrel = gs._world.create(game::Position{ 300.f, 100.f }, game::Shape{ 10.f, 10.f });
+  gs.processEvent(game::TimeElapsed{ game::TickDuration });
+  REQUIRE(gs._spatial.size() == 3);
+
+  gs._world.destroy(crate);
+  gs._world.remove<game::Shape>(barrel);
+  // not indexed again yet, but picking already skips them
+  gs.processEvent(game::Moved<game::Mouse>{ 200, 100 });
+  REQUIRE_FALSE(gs._hovered);
+  gs.processEvent(game::Moved<game::Mouse>{ 300, 100 });
+  REQUIRE_FALSE(gs._hovered);
+
+  gs.processEvent(game::TimeElapsed{ game::TickDuration });
+  REQUIRE(gs._spatial.size() == 1);
+  REQUIRE_FALSE(gs._spatial.contains(crate));
+  REQUIRE_FALSE(gs._spatial.contains(barrel));
+
+  gs._world.add(barrel, game::Shape{ 20.f, 20.f });
+  gs.processEvent(game::TimeElapsed{ game::TickDuration });
+  REQUIRE(gs._spatial.contains(barrel));
+  REQUIRE(gs._spatial.bounds(barrel)->minX == 280.f);
+}
+
+TEST_CASE("Spatial grid with 100k objects", "[.][benchmark]")
+{
+  constexpr std::size_t count = 100'000;
+  Scene scene{ count, 10'000.f, 4 };
+  WARN(fmt::format("{} objects in {} cells", scene.grid.size(), scene.grid.cellCount()));
+
+  std::mt19937 rng{ 5 };
+  std::uniform_real_distribution<float> position{ 0.f, 10'000.f };
+  std::vector<std::pair<float, float>> points(1000);
+  for (auto &point : points) { point = { position(rng), position(rng) }; }
+
+  BENCHMARK("1000 point queries")
+  {
+    std::size_t hits = 0;
+    for (const auto &[x, y] : points) {
+      scene.grid.queryPoint(x, y, [&](game::Entity) { ++hits; });
+    }
+    return hits;
+  };
+
+  BENCHMARK("1000 point queries, linear scan")
+  {
+    std::size_t hits = 0;
+    for (const auto &[x, y] : points) {
+      for (const auto &bounds : scene.bounds) { hits += bounds.contains(x, y) ? 1U : 0U; }
+    }
+    return hits;
+  };
+
+  BENCHMARK("1000 rect queries, 200x200")
+  {
+    std::size_t hits = 0;
+    for (const auto &[x, y] : points) {
+      scene.grid.queryRect(game::Bounds{ x, y, x + 200.f, y + 200.f }, [&](game::Entity) { ++hits; });
+    }
+    return hits;
+  };
+
+  BENCHMARK("1000 radius queries, r=100")
+  {
+    std::size_t hits = 0;
+    for (const auto &[x, y] : points) {
+      scene.grid.queryRadius(x, y, 100.f, [&](game::Entity) { ++hits; });
+    }
+    return hits;
+  };
+
+  BENCHMARK("100k updates, moving 1 unit")
+  {
+    for (std::uint32_t index = 0; index < count; ++index) {
+      auto &bounds = scene.bounds[index];
+      bounds = game::Bounds{ bounds.minX + 1.f, bounds.minY, bounds.maxX + 1.f, bounds.maxY };
+      scene.grid.update(entity(index), bounds);
+    }
+  };
+
+  BENCHMARK("100k updates, jumping anywhere")
+  {
+    for (std::uint32_t index = 0; index < count; ++index) {
+      scene.bounds[index] = box(position(rng), position(rng), 5.f);
+      scene.grid.update(entity(index), scene.bounds[index]);
+    }
+  };
+}
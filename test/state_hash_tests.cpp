@@ -0,0 +1,291 @@
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <chrono>
+#include <components.h>
+#include <event_recorder.h>
+#include <fmt/format.h>
+#include <game_state.h>
+#include <random>
+#include <replay_verifier.h>
+#include <rollback_session.h>
+#include <set>
+
+namespace {
+  constexpr game::Key key(const sf::Keyboard::Key code)
+  {
+    return game::Key{ false, false, false, false, code };
+  }
+
+  // A few seconds of made up play: keys, joystick buttons and sticks, one tick after every couple of events. Both
+  // joysticks are connected up front, events of joysticks that are not connected would be ignored.
+  game::EventList randomSession(const std::size_t ticks, const unsigned int seed)
+  {
+    std::mt19937 rng{ seed };
+    std::uniform_int_distribution<int> kind{ 0, 5 };
+    std::uniform_int_distribution<unsigned int> joystick{ 0, 1 };
+    std::uniform_int_distribution<unsigned int> button{ 0, 7 };
+    std::uniform_int_distribution<unsigned int> axis{ 0, 1 };
+    std::uniform_real_distribution<float> position{ -100.f, 100.f };
+    const std::array keys{ sf::Keyboard::W, sf::Keyboard::A, sf::Keyboard::S, sf::Keyboard::D, sf::Keyboard::Space };
+    std::uniform_int_distribution<std::size_t> keyIndex{ 0, keys.size() - 1 };
+
+    game::EventList events{ game::Connected<game::JoystickDevice>{ { 0, 8 } },
+                            game::Connected<game::JoystickDevice>{ { 1, 8 } } };
+    for (std::size_t tick = 0; tick < ticks; ++tick) {
+      for (int count = 0; count < 4; ++count) {
+        switch (kind(rng)) {
+        case 0:
+          events.push_back(game::Pressed<game::Key>{ key(keys.at(keyIndex(rng))) });
+          break;
+        case 1:
+          events.push_back(game::Released<game::Key>{ key(keys.at(keyIndex(rng))) });
+          break;
+        case 2:
+          events.push_back(game::Pressed<game::JoystickButton>{ joystick(rng), button(rng) });
+          break;
+        case 3:
+          events.push_back(game::Released<game::JoystickButton>{ joystick(rng), button(rng) });
+          break;
+        default:
+          events.push_back(game::Moved<game::JoystickAxis>{ joystick(rng), axis(rng), position(rng) });
+          break;
+        }
+      }
+      events.push_back(game::TimeElapsed{ game::TickDuration });
+    }
+    return events;
+  }
+
+  game::EventList record(const game::EventList &session, const std::uint32_t checkpointInterval)
+  {
+    game::GameState gs;
+    game::EventRecorder recorder{ checkpointInterval };
+    for (const auto &ev : session) {
+      recorder.processEvent(ev);
+      gs.processEvent(ev);
+      if (std::holds_alternative<game::TimeElapsed>(ev)) { recorder.checkpoint(gs.hash()); }
+    }
+    return recorder.events();
+  }
+
+  game::ReplayVerifier replay(const game::EventList &recording)
+  {
+    game::GameState gs;
+    game::ReplayVerifier verifier;
+    for (const auto &ev : recording) {
+      gs.processEvent(ev);
+      verifier.processEvent(ev, gs.hash());
+    }
+    return verifier;
+  }
+}// namespace
+
+TEST_CASE("Incremental state hash matches a full recomputation", "[hash]")
+{
+  game::GameState gs;
+  REQUIRE(gs._input.hash.value() == 0);
+
+  for (const auto &ev : randomSession(500, 7)) {
+    gs.processEvent(ev);
+    REQUIRE(gs._input.hash.value() == gs._input.computeHash());
+    REQUIRE(gs.worldHash() == gs.computeWorldHash());
+  }
+
+  const auto crate = gs._world.create(game::Position{ 10.f, 20.f }, game::Shape{ 5.f, 5.f });
+  gs.processEvent(game::TimeElapsed{ game::TickDuration });
+  REQUIRE(gs.worldHash() == gs.computeWorldHash());
+  gs._world.add(crate, game::Velocity{ 30.f, 0.f });
+  gs.processEvent(game::TimeElapsed{ game::TickDuration });
+  REQUIRE(gs.worldHash() == gs.computeWorldHash());
+  gs._world.destroy(crate);
+  const auto reused = gs._world.create(game::Position{ 10.f, 20.f });
+  REQUIRE(reused.index == crate.index);
+  gs.processEvent(game::TimeElapsed{ game::TickDuration });
+  REQUIRE(gs.worldHash() == gs.computeWorldHash());
+
+  gs.processEvent(game::Disconnected<game::JoystickDevice>{ { 1, 0 } });
+  REQUIRE(gs._input.hash.value() == gs._input.computeHash());
+  gs.processEvent(game::Connected<game::JoystickDevice>{ { 1, 4 } });
+  gs.processEvent(game::Pressed<game::JoystickButton>{ 1, 3 });
+  REQUIRE(gs._input.hash.value() == gs._input.computeHash());
+}
+
+TEST_CASE("State hash covers the world and what the mouse points at", "[hash]")
+{
+  game::GameState gs;
+  const auto initial = gs.hash();
+  REQUIRE(initial == game::GameState{}.hash());
+
+  gs.processEvent(game::Moved<game::Mouse>{ 0, 0 });
+  REQUIRE(gs._hovered);
+  REQUIRE(gs.hash() != initial);
+  gs.processEvent(game::Moved<game::Mouse>{ 300, 300 });
+  REQUIRE(gs.hash() == initial);
+
+  gs.processEvent(game::Pressed<game::MouseButton>{ sf::Mouse::Left, { 0, 0 } });
+  gs.processEvent(game::Released<game::MouseButton>{ sf::Mouse::Left, { 0, 0 } });
+  REQUIRE(gs._selected);
+  const auto selected = gs.hash();
+  REQUIRE(selected != initial);
+
+  gs.processEvent(game::TimeElapsed{ game::TickDuration / 2 });
+  REQUIRE(gs.hash() != selected);
+
+  gs._world.create(game::Position{ 50.f, 50.f });
+  gs.processEvent(game::TimeElapsed{ game::TickDuration / 2 });
+  const auto created = gs.hash();
+  gs.processEvent(game::Pressed<game::Key>{ key(sf::Keyboard::D) });
+  gs.processEvent(game::TimeElapsed{ game::TickDuration });
+  gs.processEvent(game::Released<game::Key>{ key(sf::Keyboard::D) });
+  REQUIRE(gs.hash() != created);
+}
+
+TEST_CASE("State hash depends on the state, not on how it was reached", "[hash]")
+{
+  game::GameState first;
+  first.processEvent(game::Connected<game::JoystickDevice>{ { 0, 8 } });
+  first.processEvent(game::Pressed<game::Key>{ key(sf::Keyboard::W) });
+  first.processEvent(game::Pressed<game::JoystickButton>{ 0, 1 });
+
+  game::GameState second;
+  second.processEvent(game::Connected<game::JoystickDevice>{ { 0, 8 } });
+  second.processEvent(game::Pressed<game::JoystickButton>{ 0, 1 });
+  second.processEvent(game::Pressed<game::Key>{ key(sf::Keyboard::W) });
+  REQUIRE(first.hash() == second.hash());
+
+
+  second.processEvent(game::Moved<game::JoystickAxis>{ 0, 0, 12.5f });
+  REQUIRE(first.hash() != second.hash());
+  second.processEvent(game::Moved<game::JoystickAxis>{ 0, 0, 0.f });
+  REQUIRE(first.hash() == second.hash());
+}
+
+TEST_CASE("State hash covers action edges until the step after they were seen", "[hash]")
+{
+  game::GameState gs;
+  const auto idle = gs._input.hash.value();
+  gs.processEvent(game::Pressed<game::Key>{ key(sf::Keyboard::Space) });
+  const auto pending = gs._input.hash.value();
+  gs.processEvent(game::TimeElapsed{ game::TickDuration });
+  const auto pressed = gs._input.hash.value();
+  REQUIRE(gs._input.actions.wasPressed(game::Action::Confirm));
+  gs.processEvent(game::TimeElapsed{ game::TickDuration });
+  const auto held = gs._input.hash.value();
+  REQUIRE(held == gs._input.computeHash());
+
+  const std::set hashes{ idle, pending, pressed, held };
+  REQUIRE(hashes.size() == 4);
+}
+
+TEST_CASE("Recordings carry checkpoints every N ticks", "[hash]")
+{
+  const auto recording = record(randomSession(100, 3), 10);
+  std::vector<std::uint32_t> ticks;
+  for (const auto &ev : recording) {
+    if (const auto *checkpoint = std::get_if<game::Checkpoint>(&ev)) { ticks.push_back(checkpoint->tick); }
+  }
+  REQUIRE(ticks == std::vector<std::uint32_t>{ 10, 20, 30, 40, 50, 60, 70, 80, 90, 100 });
+}
+
+TEST_CASE("Replay verifies the recorded checkpoints", "[hash]")
+{
+  auto recording = record(randomSession(100, 11), 10);
+
+  SECTION("A faithful replay matches every checkpoint")
+  {
+    const auto verifier = replay(recording);
+    REQUIRE(verifier.checkpointsVerified() == 10);
+    REQUIRE_FALSE(verifier.firstDivergence());
+  }
+
+  SECTION("Ticks merged by the recorder replay to the same world")
+  {
+    game::EventList session{ game::Pressed<game::Key>{ key(sf::Keyboard::D) } };
+    for (int frame = 0; frame < 200; ++frame) {
+      session.push_back(game::TimeElapsed{ std::chrono::microseconds{ 7'000 + 300 * (frame % 5) } });
+    }
+    const auto merged = record(session, 4);
+    REQUIRE(merged.size() < session.size());
+
+    const auto verifier = replay(merged);
+    REQUIRE(verifier.checkpointsVerified() > 0);
+    REQUIRE_FALSE(verifier.firstDivergence());
+  }
+
+  SECTION("A lost event is found between two checkpoints")
+  {
+    // drop the first joystick press after tick 42
+    std::uint32_t tick = 0;
+    const auto lost = std::find_if(recording.begin(), recording.end(), [&](const game::Event &ev) {
+      if (std::holds_alternative<game::TimeElapsed>(ev)) { ++tick; }
+      return tick > 42 && std::holds_alternative<game::Pressed<game::JoystickButton>>(ev);
+    });
+    REQUIRE(lost != recording.end());
+    recording.erase(lost);
+
+    const auto verifier = replay(recording);
+    REQUIRE(verifier.firstDivergence());
+    REQUIRE(verifier.firstDivergence()->lastMatchingTick == 40);
+    REQUIRE(verifier.firstDivergence()->tick == 50);
+  }
+}
+
+TEST_CASE("State hash overhead per tick", "[.][benchmark]")
+{
+  constexpr std::size_t ticks = 600;
+  constexpr std::size_t entities = 5'000;
+  constexpr std::uint32_t checkpointInterval = 60;
+  const auto session = randomSession(ticks, 5);
+
+  // a crowd that moves every tick, hashed like the recorder does: once per checkpoint
+  const auto measure = [&](const bool hashing) {
+    game::GameState gs;
+    std::mt19937 rng{ 9 };
+    std::uniform_real_distribution<float> coordinate{ 0.f, 2'000.f };
+    std::uniform_real_distribution<float> speed{ -50.f, 50.f };
+    for (std::size_t index = 0; index < entities; ++index) {
+      gs._world.create(game::Position{ coordinate(rng), coordinate(rng) },
+        game::Velocity{ speed(rng), speed(rng) },
+        game::Shape{ 4.f, 4.f });
+    }
+    gs.processEvent(game::TimeElapsed{ game::TickDuration });
+    gs.setHashing(hashing);
+
+    std::uint64_t sum = 0;
+    std::uint32_t tick = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto &ev : session) {
+      gs.processEvent(ev);
+      if (hashing && std::holds_alternative<game::TimeElapsed>(ev) && ++tick % checkpointInterval == 0) {
+        sum += gs.hash();
+      }
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::pair{ std::chrono::duration<double, std::nano>{ elapsed } / ticks, sum };
+  };
+
+  // best of a few runs, the difference is small enough to drown in scheduling noise otherwise
+  auto hashed = measure(true).first;
+  auto unhashed = measure(false).first;
+  for (int run = 0; run < 4; ++run) {
+    hashed = std::min(hashed, measure(true).first);
+    unhashed = std::min(unhashed, measure(false).first);
+  }
+  const auto overhead = (hashed - unhashed) / unhashed;
+  WARN(fmt::format("{} entities: {:.0f} ns per tick with hashing, {:.0f} ns without, {:.2f}% overhead",
+    entities,
+    hashed.count(),
+    unhashed.count(),
+    overhead * 100));
+  CHECK(overhead < 0.01);
+
+  BENCHMARK("Ticks with state hashing")
+  {
+    return measure(true).second;
+  };
+
+  BENCHMARK("Ticks without state hashing")
+  {
+    return measure(false).second;
+  };
+}